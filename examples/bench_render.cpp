@@ -0,0 +1,62 @@
+#include "catplot/catplot.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace catplot;
+using namespace std;
+
+// Renders the same figure repeatedly through the layout-only, SVG and PNG paths
+// and reports figures per second. Usage: catplot_bench [figures] [points]
+int main(int argc, char** argv) {
+	int figures = argc > 1 ? atoi(argv[1]) : 200;
+	int points = argc > 2 ? atoi(argv[2]) : 1000;
+	if (figures <= 0 || points <= 1) {
+		cerr << "usage: catplot_bench [figures > 0] [points > 1]" << endl;
+		return 1;
+	}
+
+	vector<double> x(points), ys(points), yc(points);
+	for (int i = 0; i < points; ++i) {
+		x[i] = 6.283185307179586 * i / (points - 1);
+		ys[i] = sin(x[i]);
+		yc[i] = cos(x[i]);
+	}
+
+	Figure fig(640, 480);
+	Axes& ax = fig.axes();
+	ax.plot(x, ys, Rgba{0, 0, 1, 1}, 2.0, "sin");
+	ax.plot(x, yc, Rgba{1, 0, 0, 1}, 2.0, "cos");
+	ax.scatter(x, ys, 2.0, Rgba{0, 0.6, 0, 1});
+	ax.set_title("Benchmark");
+	ax.grid(true);
+	ax.legend(true);
+
+	auto run = [&](const char* name, auto&& render) {
+		size_t bytes = 0;
+		auto t0 = chrono::steady_clock::now();
+		for (int i = 0; i < figures; ++i) {
+			ostringstream out;
+			render(out);
+			bytes += out.str().size();
+		}
+		double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+		cout << name << ": " << figures << " figures in " << sec << " s ("
+			<< figures / sec << " fig/s, " << bytes / figures << " bytes/fig)" << endl;
+	};
+
+	// Layout pass alone, into the counting null sink
+	auto t0 = chrono::steady_clock::now();
+	RenderStats stats;
+	for (int i = 0; i < figures; ++i) stats = fig.measure();
+	double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+	cout << "layout: " << figures << " figures in " << sec << " s (" << figures / sec << " fig/s, "
+		<< stats.primitives() << " primitives, " << stats.polylinePoints << " polyline points)" << endl;
+
+	run("svg", [&](ostream& out) { fig.save(out); });
+	run("png", [&](ostream& out) { fig.save_png(out); });
+	return 0;
+}
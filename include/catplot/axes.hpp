@@ -1,14 +1,16 @@
 #pragma once
 
+#include "series_data.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <stdexcept>
 
-namespace numbits {
-	template<typename T> class ndarray;
-}
-
 namespace catplot {
 
 struct Rgba {
@@ -23,92 +25,173 @@ struct Rgba {
 	static Rgba Blue();
 };
 
-class SvgCanvas; // fwd
+// Level-of-detail reduction applied to a line series at render time
+struct LineDecimation {
+	enum class Mode {
+		None,
+		MinMax, // keep first, last, min and max sample per pixel column (M4)
+		LTTB    // largest-triangle-three-buckets down to targetPoints samples
+	};
+	Mode mode{Mode::None};
+	size_t targetPoints{0};
+	bool parallel{false};
+	static LineDecimation none() { return {}; }
+	// Pixel-exact: vertex count is bounded by ~4x the plot width
+	static LineDecimation min_max() { return {Mode::MinMax}; }
+	// Fixed budget, visually faithful; see catplot::lttb_indices
+	static LineDecimation lttb(size_t targetPoints, bool parallel = false) {
+		if (targetPoints < 3) throw std::invalid_argument("LTTB target must be at least 3 points");
+		return {Mode::LTTB, targetPoints, parallel};
+	}
+};
+
+// Color scales for density scatter plots (low to high)
+enum class Colormap {
+	Viridis,
+	Inferno,
+	Grays
+};
+
+// How a scatter series is drawn
+struct ScatterMode {
+	enum class Mode {
+		Markers, // one circle per point
+		Density  // 2D histogram of binPx x binPx cells, log-scaled counts through a colormap
+	};
+	Mode mode{Mode::Markers};
+	int binPx{1};
+	Colormap colormap{Colormap::Viridis};
+	bool parallel{false};
+	// Markers only: points whose centers the canvas would write with the same
+	// coordinates (at its number precision) are drawn once. Applied to opaque
+	// colors only, where repeated circles cannot change the image.
+	bool dedup{false};
+	static ScatterMode markers(bool dedupOverdraw = false) {
+		ScatterMode m;
+		m.dedup = dedupOverdraw;
+		return m;
+	}
+	// Output size is bounded by the plot area instead of the point count
+	static ScatterMode density(int binPx = 1, Colormap colormap = Colormap::Viridis, bool parallel = false) {
+		if (binPx < 1) throw std::invalid_argument("Density bin size must be at least 1 pixel");
+		return {Mode::Density, binPx, colormap, parallel, false};
+	}
+};
+
+class Axes;
+class RingSeries;
+
+namespace detail {
+// Types with an expression_tag, i.e. numbits expression templates
+template<typename E, typename = void>
+struct is_numbits_expression : std::false_type {};
+template<typename E>
+struct is_numbits_expression<E, std::void_t<typename E::expression_tag>> : std::true_type {};
+} // namespace detail
+
+// Handle to a series added with Axes::plot() or Axes::scatter(), used to append
+// samples to live plots. Stays valid as long as the Axes it came from.
+class SeriesHandle {
+public:
+	SeriesHandle() = default;
+
+	void append(double x, double y);
+	void append(const double* x, const double* y, std::size_t n);
+	void append(const std::vector<double>& x, const std::vector<double>& y);
+
+	std::size_t size() const;
+	bool valid() const { return axes != nullptr; }
+
+private:
+	friend class Axes;
+	SeriesHandle(Axes* owner, bool scatterSeries, std::size_t seriesIndex)
+		: axes(owner), isScatter(scatterSeries), index(seriesIndex) {}
+
+	Axes* axes{nullptr};
+	bool isScatter{false};
+	std::size_t index{0};
+};
+
+// Formatted SVG body (polyline vertices or markers) of one series from the last
+// render. Reused, and extended with appended samples only, while everything
+// that affects the formatted text (the key) is unchanged.
+struct SeriesFragmentCache {
+	std::array<double, 10> key{};
+	std::size_t points{0};
+	std::string text;
+	bool valid{false};
+};
+
+// Extent of the data over all series of an Axes (no padding)
+struct DataBounds {
+	double xmin{0};
+	double xmax{0};
+	double ymin{0};
+	double ymax{0};
+	bool empty{true};
+};
+
+// Scratch memory used by one render pass (see Axes::last_render_arena)
+struct ArenaStats {
+	std::size_t allocations{0}; // requests served by the arena
+	std::size_t bytes{0};       // total bytes requested
+	std::size_t blocks{0};      // heap blocks the arena had to take
+};
+
+// Lookups of the rendered-subplot cache (see Figure::set_render_cache)
+struct RenderCacheStats {
+	std::size_t hits{0};
+	std::size_t misses{0};
+};
 
 class Axes {
 public:
 	Axes(int figureWidthPx, int figureHeightPx);
 
 	// Plot a line series
-	void plot(const std::vector<double>& x, const std::vector<double>& y, const Rgba& color = Rgba::Blue(), double lineWidthPx = 2.0, const std::string& label = "");
+	SeriesHandle plot(const std::vector<double>& x, const std::vector<double>& y, const Rgba& color = Rgba::Blue(), double lineWidthPx = 2.0, const std::string& label = "", const LineDecimation& decimation = LineDecimation::none());
+
+	// Plot a line series from borrowed or shared storage (see SeriesData); no copy is made
+	SeriesHandle plot(SeriesData x, SeriesData y, const Rgba& color = Rgba::Blue(), double lineWidthPx = 2.0, const std::string& label = "", const LineDecimation& decimation = LineDecimation::none());
 
-	// NumBits array overloads for plot()
+	// NumBits array overloads for plot(). The arrays are copied once, keeping their
+	// element type; use plot(SeriesData::borrow(x), SeriesData::borrow(y)) to avoid the copy.
 	template<typename T>
-	void plot(const numbits::ndarray<T>& x, const numbits::ndarray<T>& y, const Rgba& color = Rgba::Blue(), double lineWidthPx = 2.0, const std::string& label = "") {
-		// Validate inputs
-		if (x.ndim() != 1) {
-			throw std::invalid_argument("NumBits array 'x' must be 1D for plotting, got " + std::to_string(x.ndim()) + " dimensions");
-		}
-		if (y.ndim() != 1) {
-			throw std::invalid_argument("NumBits array 'y' must be 1D for plotting, got " + std::to_string(y.ndim()) + " dimensions");
-		}
-		if (x.size() != y.size()) {
-			throw std::invalid_argument("X and Y arrays must have the same size: X has " + std::to_string(x.size()) + " elements, Y has " + std::to_string(y.size()) + " elements");
-		}
-		if (x.size() == 0) {
-			throw std::invalid_argument("Cannot plot empty arrays");
-		}
-		
-		// Extract data using data() and size() methods
-		const T* x_data = x.data();
-		const T* y_data = y.data();
-		size_t n = x.size();
-		
-		// Convert NumBits arrays to std::vector for internal processing
-		std::vector<double> x_vec;
-		std::vector<double> y_vec;
-		x_vec.reserve(n);
-		y_vec.reserve(n);
-		
-		// Use direct pointer access for better performance
-		for (size_t i = 0; i < n; ++i) {
-			x_vec.push_back(static_cast<double>(x_data[i]));
-			y_vec.push_back(static_cast<double>(y_data[i]));
-		}
-		
-		// Call existing method that works with std::vector<double>
-		plot(x_vec, y_vec, color, lineWidthPx, label);
+	SeriesHandle plot(const numbits::ndarray<T>& x, const numbits::ndarray<T>& y, const Rgba& color = Rgba::Blue(), double lineWidthPx = 2.0, const std::string& label = "", const LineDecimation& decimation = LineDecimation::none()) {
+		validate_arrays(x.ndim(), y.ndim(), x.size(), y.size(), "plotting");
+		return plot(SeriesData::copy_of(x), SeriesData::copy_of(y), color, lineWidthPx, label, decimation);
 	}
 
+	// Fused NumBits expressions (numbits/expression.hpp) for x and/or y: evaluated
+	// once, straight into the series buffer, without intermediate arrays
+	template<typename X, typename Y, typename = std::enable_if_t<detail::is_numbits_expression<X>::value || detail::is_numbits_expression<Y>::value>>
+	SeriesHandle plot(const X& x, const Y& y, const Rgba& color = Rgba::Blue(), double lineWidthPx = 2.0, const std::string& label = "", const LineDecimation& decimation = LineDecimation::none()) {
+		validate_arrays(x.ndim(), y.ndim(), x.size(), y.size(), "plotting");
+		return plot(series_of(x), series_of(y), color, lineWidthPx, label, decimation);
+	}
+
+	// Line series with bounded history: keeps the newest `capacity` samples in a
+	// ring buffer. Samples are added with append() on the returned handle and
+	// overwrite the oldest ones once the buffer is full; memory stays constant.
+	SeriesHandle plot_ring(std::size_t capacity, const Rgba& color = Rgba::Blue(), double lineWidthPx = 2.0, const std::string& label = "", const LineDecimation& decimation = LineDecimation::none());
+
 	// Scatter points with circular markers
-	void scatter(const std::vector<double>& x, const std::vector<double>& y, double radiusPx = 3.0, const Rgba& color = Rgba::Red(), const std::string& label = "");
+	SeriesHandle scatter(const std::vector<double>& x, const std::vector<double>& y, double radiusPx = 3.0, const Rgba& color = Rgba::Red(), const std::string& label = "", const ScatterMode& mode = ScatterMode::markers());
+
+	// Scatter points from borrowed or shared storage (see SeriesData); no copy is made
+	SeriesHandle scatter(SeriesData x, SeriesData y, double radiusPx = 3.0, const Rgba& color = Rgba::Red(), const std::string& label = "", const ScatterMode& mode = ScatterMode::markers());
 
 	// NumBits array overloads for scatter()
 	template<typename T>
-	void scatter(const numbits::ndarray<T>& x, const numbits::ndarray<T>& y, double radiusPx = 3.0, const Rgba& color = Rgba::Red(), const std::string& label = "") {
-		// Validate inputs
-		if (x.ndim() != 1) {
-			throw std::invalid_argument("NumBits array 'x' must be 1D for scatter plotting, got " + std::to_string(x.ndim()) + " dimensions");
-		}
-		if (y.ndim() != 1) {
-			throw std::invalid_argument("NumBits array 'y' must be 1D for scatter plotting, got " + std::to_string(y.ndim()) + " dimensions");
-		}
-		if (x.size() != y.size()) {
-			throw std::invalid_argument("X and Y arrays must have the same size: X has " + std::to_string(x.size()) + " elements, Y has " + std::to_string(y.size()) + " elements");
-		}
-		if (x.size() == 0) {
-			throw std::invalid_argument("Cannot plot empty arrays");
-		}
-		
-		// Extract data using data() and size() methods
-		const T* x_data = x.data();
-		const T* y_data = y.data();
-		size_t n = x.size();
-		
-		// Convert NumBits arrays to std::vector for internal processing
-		std::vector<double> x_vec;
-		std::vector<double> y_vec;
-		x_vec.reserve(n);
-		y_vec.reserve(n);
-		
-		// Use direct pointer access for better performance
-		for (size_t i = 0; i < n; ++i) {
-			x_vec.push_back(static_cast<double>(x_data[i]));
-			y_vec.push_back(static_cast<double>(y_data[i]));
-		}
-		
-		// Call existing method that works with std::vector<double>
-		scatter(x_vec, y_vec, radiusPx, color, label);
+	SeriesHandle scatter(const numbits::ndarray<T>& x, const numbits::ndarray<T>& y, double radiusPx = 3.0, const Rgba& color = Rgba::Red(), const std::string& label = "", const ScatterMode& mode = ScatterMode::markers()) {
+		validate_arrays(x.ndim(), y.ndim(), x.size(), y.size(), "scatter plotting");
+		return scatter(SeriesData::copy_of(x), SeriesData::copy_of(y), radiusPx, color, label, mode);
+	}
+
+	template<typename X, typename Y, typename = std::enable_if_t<detail::is_numbits_expression<X>::value || detail::is_numbits_expression<Y>::value>>
+	SeriesHandle scatter(const X& x, const Y& y, double radiusPx = 3.0, const Rgba& color = Rgba::Red(), const std::string& label = "", const ScatterMode& mode = ScatterMode::markers()) {
+		validate_arrays(x.ndim(), y.ndim(), x.size(), y.size(), "scatter plotting");
+		return scatter(series_of(x), series_of(y), radiusPx, color, label, mode);
 	}
 
 	// Labels
@@ -120,26 +203,67 @@ public:
 	void grid(bool enabled);
 	void legend(bool enabled);
 
+	// Fixed axis limits (lo < hi) instead of the padded data extent. Data outside
+	// the limits is clipped: scatter points are dropped and lines are split at
+	// the plot box. Lines with ascending x only visit the visible range.
+	void set_xlim(double lo, double hi);
+	void set_ylim(double lo, double hi);
+
+	// Min/max over all series, NaN samples ignored. Computed on first use and
+	// cached until a series is added or mark_changed() is called; data behind
+	// borrowed series must not change in between.
+	DataBounds data_bounds() const;
+
+	// Arena statistics of the most recent render of this Axes. Transient render
+	// buffers come from a per-render arena; the counts depend on the number of
+	// series, not on the number of points.
+	ArenaStats last_render_arena() const;
+
+	// Counter bumped by every call that changes what this Axes draws (series,
+	// appends, labels, decorations, limits). Data behind borrowed series is not
+	// watched: call mark_changed() after modifying it in place, which also drops
+	// what was derived from the data (bounds, whether x ascends).
+	uint64_t content_version() const { return version; }
+	void mark_changed();
+
+	// Hits and misses of the rendered-fragment cache of this Axes
+	RenderCacheStats render_cache_stats() const;
+
 	// Save as SVG (called by Figure)
 	std::string render_svg() const;
 
-	// Render into an existing SVG canvas region
-	void render_to(SvgCanvas& canvas, double x, double y, double w, double h) const;
+	// Render into an existing canvas region (any canvas listed in src/canvas.hpp)
+	template<typename CanvasT>
+	void render_to(CanvasT& canvas, double x, double y, double w, double h) const;
 
 private:
+	friend class SeriesHandle;
+	friend class Figure;
+
 	struct LineSeries {
-		std::vector<double> x;
-		std::vector<double> y;
+		SeriesData x;
+		SeriesData y;
 		Rgba color;
-		double widthPx;
+		double widthPx{2.0};
 		std::string label;
+		LineDecimation decimation;
+		// Only used for series backed by their own buffer (see render_to)
+		mutable SeriesFragmentCache svgCache{};
+		// Set for plot_ring() series; x and y are unused then
+		std::shared_ptr<RingSeries> ring;
+		// Whether x is ascending, found on first use with clipping and kept up
+		// to date by appends
+		mutable bool sortKnown{false};
+		mutable bool xSorted{false};
 	};
 	struct ScatterSeries {
-		std::vector<double> x;
-		std::vector<double> y;
-		double radiusPx;
+		SeriesData x;
+		SeriesData y;
+		double radiusPx{3.0};
 		Rgba color;
 		std::string label;
+		ScatterMode mode;
+		mutable SeriesFragmentCache svgCache{};
 	};
 
 	int widthPx;
@@ -158,8 +282,42 @@ private:
 	std::string ylabel;
 	bool showGrid{false};
 	bool showLegend{false};
+	bool xlimSet{false};
+	bool ylimSet{false};
+	double xlimLo{0}, xlimHi{1};
+	double ylimLo{0}, ylimHi{1};
+
+	// data_bounds() cache, reset by plot()/scatter()
+	mutable DataBounds boundsCache;
+	mutable bool boundsValid{false};
+	mutable ArenaStats lastArena;
+
+	// SVG fragments of recent render_to() passes, one per viewport and
+	// precision, valid while the content version matches
+	struct RenderedFragment {
+		uint64_t version{0};
+		std::array<double, 5> key{}; // x, y, w, h, precision
+		std::string svg;
+	};
+	uint64_t version{0};
+	mutable std::vector<RenderedFragment> renderCache;
+	mutable RenderCacheStats cacheStats;
 
 	// helpers
+	struct StagedSeries;
+	void stage_series(StagedSeries& out, const DataBounds& view) const;
+	DataBounds view_bounds() const;
+	const std::string& cached_svg_fragment(double x, double y, double w, double h, int precision) const;
+	void append_samples(bool scatterSeries, std::size_t index, const double* x, const double* y, std::size_t n);
+	template<typename T>
+	static SeriesData series_of(const numbits::ndarray<T>& a) { return SeriesData::copy_of(a); }
+	template<typename E, typename = std::enable_if_t<detail::is_numbits_expression<E>::value>>
+	static SeriesData series_of(const E& expr) {
+		std::vector<typename E::value_type> v(expr.size());
+		expr.evaluate_into(v.data());
+		return SeriesData::own(std::move(v));
+	}
+	static void validate_arrays(size_t xdim, size_t ydim, size_t xsize, size_t ysize, const char* what);
 	static std::pair<double, double> minmax(const std::vector<double>& v);
 	static void expand_range(double& vmin, double& vmax, double expandFrac);
 };
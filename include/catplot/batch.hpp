@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace catplot {
+
+class Figure;
+class ThreadPool;
+
+// One figure of a batch and the SVG file it is written to
+struct BatchJob {
+	const Figure* figure{nullptr};
+	std::string path;
+};
+
+// Saves many figures concurrently on one shared worker pool. Each figure is
+// rendered whole by a single thread (its own render threads are not used), so
+// throughput scales with the number of figures rather than subplots. Workers
+// keep their document buffer and render-arena blocks between figures. A
+// figure must not appear in more than one job of a batch.
+class BatchRenderer {
+public:
+	// threads: 0 uses one per hardware core. maxOpenFiles bounds the output
+	// files open at once; 0 allows one per thread.
+	explicit BatchRenderer(int threads = 0, std::size_t maxOpenFiles = 0);
+	~BatchRenderer();
+
+	BatchRenderer(const BatchRenderer&) = delete;
+	BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+	// Render and write every job. Jobs are handed out dynamically, so uneven
+	// figures balance across threads. The first error (e.g. a file that cannot
+	// be opened) is rethrown once running jobs finish; jobs not yet started
+	// are skipped then.
+	void save_all(const std::vector<BatchJob>& jobs);
+
+	int threads() const;
+	std::size_t max_open_files() const { return maxOpen; }
+
+private:
+	class FileSlots;
+
+	std::unique_ptr<ThreadPool> pool;
+	std::unique_ptr<FileSlots> slots;
+	std::size_t maxOpen;
+};
+
+} // namespace catplot
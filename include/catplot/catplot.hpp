@@ -1,4 +1,7 @@
 #pragma once
 
 #include "figure.hpp"
+#include "batch.hpp"
 #include "axes.hpp"
+#include "series_data.hpp"
+#include "downsample.hpp"
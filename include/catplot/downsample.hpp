@@ -0,0 +1,165 @@
+#pragma once
+
+#include "numbits/ndarray.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace catplot {
+
+namespace detail {
+
+// Buckets handled per task by the parallel LTTB variant
+constexpr std::size_t kLttbChunkBuckets = 256;
+
+// Boundary of bucket b when samples 1..n-2 are split into `buckets` buckets
+inline std::size_t lttb_bound(std::size_t b, std::size_t n, std::size_t buckets) {
+	return 1 + (b * (n - 2)) / buckets;
+}
+
+template<typename GetX, typename GetY>
+std::pair<double, double> lttb_average(std::size_t lo, std::size_t hi, GetX& x, GetY& y) {
+	double sx = 0.0, sy = 0.0;
+	for (std::size_t k = lo; k < hi; ++k) { sx += x(k); sy += y(k); }
+	double inv = 1.0 / static_cast<double>(hi - lo);
+	return {sx * inv, sy * inv};
+}
+
+// Index of the sample in [lo, hi) forming the largest triangle with anchor a and point c
+template<typename GetX, typename GetY>
+std::size_t lttb_select(std::size_t lo, std::size_t hi, double ax, double ay, double cx, double cy, GetX& x, GetY& y) {
+	std::size_t best = lo;
+	double bestArea = -1.0;
+	for (std::size_t k = lo; k < hi; ++k) {
+		// Twice the triangle area; the constant factor does not change the argmax
+		double area = std::abs((ax - cx) * (y(k) - ay) - (ax - x(k)) * (cy - ay));
+		if (area > bestArea) { bestArea = area; best = k; }
+	}
+	return best;
+}
+
+template<typename GetX, typename GetY>
+std::vector<std::size_t> lttb_indices(std::size_t n, std::size_t threshold, GetX x, GetY y, bool parallel) {
+	if (threshold < 3) throw std::invalid_argument("LTTB target must be at least 3 points, got " + std::to_string(threshold));
+	std::vector<std::size_t> out;
+	if (threshold >= n) {
+		out.resize(n);
+		for (std::size_t k = 0; k < n; ++k) out[k] = k;
+		return out;
+	}
+	const std::size_t buckets = threshold - 2;
+	out.resize(threshold);
+	out.front() = 0;
+	out.back() = n - 1;
+
+	if (!parallel) {
+		// Classic sequential LTTB: the anchor is the point selected in the previous bucket
+		std::size_t a = 0;
+		for (std::size_t b = 0; b < buckets; ++b) {
+			std::size_t lo = lttb_bound(b, n, buckets);
+			std::size_t hi = lttb_bound(b + 1, n, buckets);
+			std::size_t nlo = hi;
+			std::size_t nhi = (b + 1 < buckets) ? lttb_bound(b + 2, n, buckets) : n;
+			auto [cx, cy] = lttb_average(nlo, nhi, x, y);
+			a = lttb_select(lo, hi, x(a), y(a), cx, cy, x, y);
+			out[b + 1] = a;
+		}
+		return out;
+	}
+
+	// Parallel variant: bucket centroids are computed independently, then buckets are
+	// processed in fixed-size chunks. The first bucket of each chunk provisionally
+	// anchors on the centroid of the preceding bucket, which makes the chunks
+	// independent. A sequential fix-up pass then replays each chunk from the true
+	// anchor until its selection agrees with the provisional one, so the result is
+	// identical to the classic algorithm.
+	std::vector<double> cxs(buckets + 1), cys(buckets + 1);
+	const std::ptrdiff_t nb = static_cast<std::ptrdiff_t>(buckets);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static)
+#endif
+	for (std::ptrdiff_t b = 0; b < nb; ++b) {
+		std::size_t ub = static_cast<std::size_t>(b);
+		auto c = lttb_average(lttb_bound(ub, n, buckets), lttb_bound(ub + 1, n, buckets), x, y);
+		cxs[ub] = c.first;
+		cys[ub] = c.second;
+	}
+	cxs[buckets] = x(n - 1);
+	cys[buckets] = y(n - 1);
+
+	const std::ptrdiff_t chunks = static_cast<std::ptrdiff_t>((buckets + kLttbChunkBuckets - 1) / kLttbChunkBuckets);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (std::ptrdiff_t c = 0; c < chunks; ++c) {
+		std::size_t b0 = static_cast<std::size_t>(c) * kLttbChunkBuckets;
+		std::size_t b1 = std::min(b0 + kLttbChunkBuckets, buckets);
+		double ax = b0 == 0 ? x(0) : cxs[b0 - 1];
+		double ay = b0 == 0 ? y(0) : cys[b0 - 1];
+		for (std::size_t b = b0; b < b1; ++b) {
+			std::size_t a = lttb_select(lttb_bound(b, n, buckets), lttb_bound(b + 1, n, buckets), ax, ay, cxs[b + 1], cys[b + 1], x, y);
+			out[b + 1] = a;
+			ax = x(a);
+			ay = y(a);
+		}
+	}
+
+	for (std::size_t b0 = kLttbChunkBuckets; b0 < buckets; b0 += kLttbChunkBuckets) {
+		std::size_t b1 = std::min(b0 + kLttbChunkBuckets, buckets);
+		std::size_t a = out[b0];
+		for (std::size_t b = b0; b < b1; ++b) {
+			a = lttb_select(lttb_bound(b, n, buckets), lttb_bound(b + 1, n, buckets), x(a), y(a), cxs[b + 1], cys[b + 1], x, y);
+			if (a == out[b + 1]) break; // rest of the chunk already follows from this anchor
+			out[b + 1] = a;
+		}
+	}
+	return out;
+}
+
+} // namespace detail
+
+// Largest-Triangle-Three-Buckets downsampling: indices of at most `threshold`
+// samples (always including the first and last) that best preserve the visual
+// shape of the series. Runs in O(n). With `parallel` the bucket scans run in
+// independent chunks (OpenMP when available) with the same result as the
+// sequential algorithm; see detail::lttb_indices.
+template<typename TX, typename TY>
+std::vector<std::size_t> lttb_indices(const TX* x, const TY* y, std::size_t n, std::size_t threshold,
+	bool parallel = false, std::ptrdiff_t xStride = 1, std::ptrdiff_t yStride = 1) {
+	auto gx = [x, xStride](std::size_t k) { return static_cast<double>(x[static_cast<std::ptrdiff_t>(k) * xStride]); };
+	auto gy = [y, yStride](std::size_t k) { return static_cast<double>(y[static_cast<std::ptrdiff_t>(k) * yStride]); };
+	return detail::lttb_indices(n, threshold, gx, gy, parallel);
+}
+
+template<typename T>
+std::vector<std::size_t> lttb_indices(const numbits::ndarray<T>& x, const numbits::ndarray<T>& y, std::size_t threshold, bool parallel = false) {
+	if (x.ndim() != 1 || y.ndim() != 1) throw std::invalid_argument("LTTB requires 1D arrays");
+	if (x.size() != y.size()) throw std::invalid_argument("X and Y arrays must have the same size");
+	return lttb_indices(x.data(), y.data(), x.size(), threshold, parallel,
+		static_cast<std::ptrdiff_t>(x.strides()[0]), static_cast<std::ptrdiff_t>(y.strides()[0]));
+}
+
+// Downsampled copies of x and y holding at most `threshold` points
+template<typename T>
+std::pair<numbits::ndarray<T>, numbits::ndarray<T>> lttb(const numbits::ndarray<T>& x, const numbits::ndarray<T>& y, std::size_t threshold, bool parallel = false) {
+	std::vector<std::size_t> idx = lttb_indices(x, y, threshold, parallel);
+	numbits::ndarray<T> xo(numbits::Shape{idx.size()});
+	numbits::ndarray<T> yo(numbits::Shape{idx.size()});
+	const std::ptrdiff_t xs = static_cast<std::ptrdiff_t>(x.strides()[0]);
+	const std::ptrdiff_t ys = static_cast<std::ptrdiff_t>(y.strides()[0]);
+	for (std::size_t i = 0; i < idx.size(); ++i) {
+		xo[i] = x.data()[static_cast<std::ptrdiff_t>(idx[i]) * xs];
+		yo[i] = y.data()[static_cast<std::ptrdiff_t>(idx[i]) * ys];
+	}
+	return {std::move(xo), std::move(yo)};
+}
+
+} // namespace catplot
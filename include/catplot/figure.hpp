@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -7,10 +9,33 @@
 namespace catplot {
 
 class Axes;
+class ThreadPool;
+class SvgCanvas;
+struct ArenaStats;
+struct RenderCacheStats;
+
+// Primitive counts and drawn extent of one layout pass (see Figure::measure)
+struct RenderStats {
+	std::size_t lines{0};
+	std::size_t polylines{0};
+	std::size_t polylinePoints{0};
+	std::size_t circles{0};
+	std::size_t rects{0};
+	std::size_t texts{0};
+	std::size_t textChars{0};
+	std::size_t groups{0};
+	// Bounding box of drawn geometry in figure pixels (text anchors only)
+	double minX{0}, minY{0}, maxX{0}, maxY{0};
+
+	std::size_t primitives() const { return lines + polylines + circles + rects + texts; }
+};
 
 class Figure {
 public:
 	Figure(int width_px = 800, int height_px = 600);
+	~Figure();
+	Figure(Figure&&) noexcept;
+	Figure& operator=(Figure&&) noexcept;
 
 	Axes& axes();
 	const Axes& axes() const;
@@ -24,16 +49,55 @@ public:
 
 	// Save the figure to an SVG file
 	void save(const std::string& filepath) const;
-	// PNG export stub (to be implemented with a raster backend)
+	// Stream the figure as SVG to any output stream
+	void save(std::ostream& out) const;
+	// Significant digits for numbers written to SVG (default 6)
+	void set_svg_precision(int significantDigits);
+	int svg_precision() const;
+
+	// Save the figure as PNG using the built-in software rasterizer
 	void save_png(const std::string& filepath) const;
+	void save_png(std::ostream& out) const;
+
+	// Worker threads used to render subplot cells concurrently: 1 renders
+	// serially (default), 0 uses one thread per hardware core. Output is
+	// byte-identical for any count.
+	void set_render_threads(int threads);
+	int render_threads() const;
+
+	// Run the layout pass into a null sink and report what would be drawn
+	RenderStats measure() const;
+
+	// Render-arena statistics of the last save/measure, summed over all subplots
+	// (see Axes::last_render_arena)
+	ArenaStats last_render_arena() const;
+
+	// Keep the SVG of each subplot between saves and splice it back while the
+	// subplot is unchanged (see Axes::content_version); only modified subplots
+	// are rendered again. Off by default, as every subplot's SVG is then held
+	// in memory. PNG output is not cached.
+	void set_render_cache(bool enabled);
+	bool render_cache() const;
+	// Cache hits and misses summed over all subplots
+	RenderCacheStats render_cache_stats() const;
 
 private:
+	friend class BatchRenderer;
+
 	int widthPx;
 	int heightPx;
 	int gridRows{1};
 	int gridCols{1};
+	int svgPrecision{6};
+	int renderThreads{1};
+	bool renderCache{false};
 	std::vector<std::unique_ptr<Axes>> axesGrid; // size = gridRows*gridCols
+	std::unique_ptr<ThreadPool> pool; // set when renderThreads != 1
 	void ensure_grid(int r, int c);
+	// Subplot cells run on cellPool when it is set, serially otherwise
+	template<typename CanvasT>
+	void render_cells(CanvasT& canvas, ThreadPool* cellPool) const;
+	void write_svg(SvgCanvas& canvas, ThreadPool* cellPool) const;
 };
 
 } // namespace catplot
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace numbits {
+	template<typename T> class ndarray;
+}
+
+namespace catplot {
+
+// Element types a series can be stored as. Values stay in their source type
+// and are only widened to double when the renderer reads them.
+enum class ElementType {
+	Float64,
+	Float32,
+	Int64,
+	Int32,
+	Int16,
+	Int8,
+	UInt64,
+	UInt32,
+	UInt16,
+	UInt8
+};
+
+template<typename T>
+constexpr ElementType element_type_of() {
+	if constexpr (std::is_same_v<T, double>) return ElementType::Float64;
+	else if constexpr (std::is_same_v<T, float>) return ElementType::Float32;
+	else if constexpr (std::is_same_v<T, int64_t>) return ElementType::Int64;
+	else if constexpr (std::is_same_v<T, int32_t>) return ElementType::Int32;
+	else if constexpr (std::is_same_v<T, int16_t>) return ElementType::Int16;
+	else if constexpr (std::is_same_v<T, int8_t>) return ElementType::Int8;
+	else if constexpr (std::is_same_v<T, uint64_t>) return ElementType::UInt64;
+	else if constexpr (std::is_same_v<T, uint32_t>) return ElementType::UInt32;
+	else if constexpr (std::is_same_v<T, uint16_t>) return ElementType::UInt16;
+	else if constexpr (std::is_same_v<T, uint8_t>) return ElementType::UInt8;
+	else static_assert(std::is_same_v<T, void>, "Unsupported series element type");
+}
+
+// Strided, type-erased view over one coordinate array of a series.
+//
+// borrow() keeps only a pointer: the caller must keep the buffer alive until
+// the figure has been saved. share() and own() keep the buffer alive through
+// a shared owner, so the series can outlive the caller's handle.
+class SeriesData {
+public:
+	SeriesData() = default;
+
+	template<typename T>
+	static SeriesData borrow(const T* data, std::size_t n, std::ptrdiff_t stride = 1) {
+		if (n > 0 && data == nullptr) throw std::invalid_argument("SeriesData: null data pointer");
+		SeriesData s;
+		s.ptr = data;
+		s.count = n;
+		s.strideElems = stride;
+		s.elemType = element_type_of<T>();
+		return s;
+	}
+
+	template<typename T>
+	static SeriesData borrow(const std::vector<T>& v) {
+		return borrow(v.data(), v.size());
+	}
+
+	template<typename T>
+	static SeriesData borrow(const numbits::ndarray<T>& a) {
+		if (a.ndim() != 1) {
+			throw std::invalid_argument("NumBits array must be 1D for plotting, got " + std::to_string(a.ndim()) + " dimensions");
+		}
+		return borrow(a.data(), a.size(), static_cast<std::ptrdiff_t>(a.strides()[0]));
+	}
+
+	template<typename T>
+	static SeriesData share(std::shared_ptr<const std::vector<T>> v) {
+		if (!v) throw std::invalid_argument("SeriesData: null shared vector");
+		SeriesData s = borrow(v->data(), v->size());
+		s.owner = std::move(v);
+		return s;
+	}
+
+	template<typename T>
+	static SeriesData share(std::shared_ptr<const numbits::ndarray<T>> a) {
+		if (!a) throw std::invalid_argument("SeriesData: null shared array");
+		SeriesData s = borrow(*a);
+		s.owner = std::move(a);
+		return s;
+	}
+
+	// Take ownership of a buffer (moved in, no element copy)
+	template<typename T>
+	static SeriesData own(std::vector<T>&& v) {
+		if constexpr (std::is_same_v<T, double>) {
+			// Owned doubles can later grow in place through append()
+			auto buffer = std::make_shared<std::vector<double>>(std::move(v));
+			SeriesData s = borrow(buffer->data(), buffer->size());
+			s.growable = buffer.get();
+			s.owner = std::move(buffer);
+			return s;
+		} else {
+			return share(std::make_shared<const std::vector<T>>(std::move(v)));
+		}
+	}
+
+	// Copy a (possibly strided) 1D array into an owned buffer of the same element type
+	template<typename T>
+	static SeriesData copy_of(const numbits::ndarray<T>& a) {
+		SeriesData view = borrow(a);
+		std::vector<T> v(view.count);
+		const T* src = a.data();
+		for (std::size_t i = 0; i < view.count; ++i) v[i] = src[static_cast<std::ptrdiff_t>(i) * view.strideElems];
+		return own(std::move(v));
+	}
+
+	std::size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	ElementType type() const { return elemType; }
+	std::ptrdiff_t stride() const { return strideElems; }
+	const void* data() const { return ptr; }
+	// True when the samples live in a double buffer owned by the series (own() of
+	// a double vector, or after append()), so the caller cannot modify them
+	bool owns_buffer() const { return growable != nullptr; }
+
+	// Invoke f(const T* base, std::ptrdiff_t stride, std::size_t n) with the concrete element type
+	template<typename F>
+	decltype(auto) visit(F&& f) const {
+		switch (elemType) {
+		case ElementType::Float32: return f(static_cast<const float*>(ptr), strideElems, count);
+		case ElementType::Int64: return f(static_cast<const int64_t*>(ptr), strideElems, count);
+		case ElementType::Int32: return f(static_cast<const int32_t*>(ptr), strideElems, count);
+		case ElementType::Int16: return f(static_cast<const int16_t*>(ptr), strideElems, count);
+		case ElementType::Int8: return f(static_cast<const int8_t*>(ptr), strideElems, count);
+		case ElementType::UInt64: return f(static_cast<const uint64_t*>(ptr), strideElems, count);
+		case ElementType::UInt32: return f(static_cast<const uint32_t*>(ptr), strideElems, count);
+		case ElementType::UInt16: return f(static_cast<const uint16_t*>(ptr), strideElems, count);
+		case ElementType::UInt8: return f(static_cast<const uint8_t*>(ptr), strideElems, count);
+		case ElementType::Float64:
+		default: return f(static_cast<const double*>(ptr), strideElems, count);
+		}
+	}
+
+	double operator[](std::size_t i) const {
+		return visit([i](const auto* base, std::ptrdiff_t stride, std::size_t) {
+			return static_cast<double>(base[static_cast<std::ptrdiff_t>(i) * stride]);
+		});
+	}
+
+	// Append samples. The first append on borrowed, shared or non-double storage
+	// copies the series into an owned double buffer (copy-on-write when other
+	// SeriesData copies share it); after that appends are amortized O(n).
+	void append(const double* values, std::size_t n) {
+		if (n == 0) return;
+		if (growable == nullptr || owner.use_count() != 1) {
+			auto buffer = std::make_shared<std::vector<double>>();
+			buffer->reserve(std::max(count + n, 2 * count));
+			copy_to(*buffer);
+			growable = buffer.get();
+			owner = std::move(buffer);
+		}
+		growable->insert(growable->end(), values, values + n);
+		ptr = growable->data();
+		count = growable->size();
+		strideElems = 1;
+		elemType = ElementType::Float64;
+	}
+
+	// Widen into a double buffer (used by the renderer)
+	template<typename Alloc>
+	void copy_to(std::vector<double, Alloc>& out) const {
+		out.resize(count);
+		visit([&out](const auto* base, std::ptrdiff_t stride, std::size_t n) {
+			for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<double>(base[static_cast<std::ptrdiff_t>(i) * stride]);
+		});
+	}
+
+	std::vector<double> to_vector() const {
+		std::vector<double> out;
+		copy_to(out);
+		return out;
+	}
+
+private:
+	const void* ptr{nullptr};
+	std::size_t count{0};
+	std::ptrdiff_t strideElems{1};
+	ElementType elemType{ElementType::Float64};
+	std::shared_ptr<const void> owner;
+	// Owned double buffer that append() may grow in place (kept alive by owner)
+	std::vector<double>* growable{nullptr};
+};
+
+} // namespace catplot
@@ -2,81 +2,114 @@
 
 #include "ndarray.hpp"
 #include "utils.hpp"
+#include "nd_iterator.hpp"
 #include <vector>
 
 namespace numbits {
 
+// Strides (in elements) that read `arr` as if it had `target_shape`, which must
+// be a broadcast of its shape. Broadcast dimensions get stride 0, so the same
+// elements are revisited instead of copied.
+template<typename T>
+Strides broadcast_strides(const ndarray<T>& arr, const Shape& target_shape) {
+    Strides strides(target_shape.size(), 0);
+    size_t offset = target_shape.size() - arr.ndim();
+    for (size_t i = 0; i < arr.ndim(); ++i) {
+        if (arr.shape()[i] != 1) strides[offset + i] = arr.strides()[i];
+    }
+    return strides;
+}
+
+// One entry of broadcast_strides(arr, shape) for a target of `target_ndim`
+// dimensions, without building the vector
+template<typename T>
+size_t broadcast_stride(const ndarray<T>& arr, size_t target_ndim, size_t d) {
+    size_t offset = target_ndim - arr.ndim();
+    if (d < offset || arr.shape()[d - offset] == 1) return 0;
+    return arr.strides()[d - offset];
+}
+
+// Element-at-a-time walk of `arr` broadcast to `target_shape`, in row-major
+// order. The source offset is updated incrementally; bulk loops should use
+// NdIterator, which hands out whole inner runs.
 template<typename T>
 class BroadcastIterator {
 public:
     BroadcastIterator(const ndarray<T>& arr, const Shape& target_shape)
-        : ndarray_(arr), target_shape_(target_shape), 
-          target_strides_(compute_strides(target_shape)),
-          ndarray_strides_(arr.strides()),
+        : data_(arr.data()), target_shape_(target_shape),
+          strides_(broadcast_strides(arr, target_shape)),
           current_index_(target_shape.size(), 0),
-          flat_index_(0) {
-        // Expand ndarray shape to match target dimensions
-        expanded_shape_.resize(target_shape.size(), 1);
-        size_t offset = target_shape.size() - arr.ndim();
-        for (size_t i = 0; i < arr.ndim(); ++i) {
-            expanded_shape_[offset + i] = arr.shape()[i];
-        }
-        expanded_strides_ = compute_strides(expanded_shape_);
-    }
+          size_(compute_size(target_shape)),
+          offset_(0), flat_index_(0) {}
 
-    T get_value() const {
-        // Calculate the index in the original ndarray
-        size_t ndarray_index = 0;
-        for (size_t i = 0; i < target_shape_.size(); ++i) {
-            size_t dim_index = current_index_[i];
-            // If this dimension was 1 in the original, use index 0
-            if (expanded_shape_[i] == 1) {
-                dim_index = 0;
-            }
-            ndarray_index += dim_index * expanded_strides_[i];
-        }
-        return ndarray_.data()[ndarray_index];
-    }
+    T get_value() const { return data_[offset_]; }
 
     void increment() {
-        for (int i = static_cast<int>(target_shape_.size()) - 1; i >= 0; --i) {
-            current_index_[i]++;
-            if (current_index_[i] < target_shape_[i]) {
-                break;
-            }
+        for (size_t i = target_shape_.size(); i-- > 0;) {
+            offset_ += strides_[i];
+            if (++current_index_[i] < target_shape_[i]) break;
+            offset_ -= strides_[i] * target_shape_[i];
             current_index_[i] = 0;
         }
         flat_index_++;
     }
 
-    bool is_end() const {
-        return flat_index_ >= compute_size(target_shape_);
-    }
+    bool is_end() const { return flat_index_ >= size_; }
 
     size_t flat_index() const { return flat_index_; }
 
 private:
-    const ndarray<T>& ndarray_;
+    const T* data_;
     Shape target_shape_;
-    Strides target_strides_;
-    Strides ndarray_strides_;
-    Shape expanded_shape_;
-    Strides expanded_strides_;
+    Strides strides_;
     std::vector<size_t> current_index_;
+    size_t size_;
+    size_t offset_;
     size_t flat_index_;
 };
 
+// result[i] = op(a[i], b[i]) over the broadcast shape of a and b, which result
+// must already have. Operands are read through stride-0 views and nothing is
+// allocated. Same-shape operands take a flat loop.
+template<typename T, typename R, typename Op>
+void broadcast_apply(const ndarray<T>& a, const ndarray<T>& b, ndarray<R>& result, Op op) {
+    const Shape& shape = result.shape();
+    const T* pa = a.data();
+    const T* pb = b.data();
+    R* out = result.data();
+    if (a.shape() == shape && b.shape() == shape) {
+        for (size_t i = 0; i < result.size(); ++i) out[i] = op(pa[i], pb[i]);
+        return;
+    }
+
+    const size_t ndim = shape.size();
+    NdIterator<3> it(shape, [&](size_t k, size_t d) {
+        return k == 0 ? result.strides()[d] : broadcast_stride(k == 1 ? a : b, ndim, d);
+    });
+    it.for_each_run([&](const NdIterator<3>::Offsets& off, size_t n, const NdIterator<3>::Offsets& step) {
+        R* o = out + off[0];
+        const T* ra = pa + off[1];
+        const T* rb = pb + off[2];
+        // A zero inner stride is a scalar operand
+        if (step[1] == 1 && step[2] == 1) {
+            for (size_t j = 0; j < n; ++j) o[j] = op(ra[j], rb[j]);
+        } else if (step[1] == 1 && step[2] == 0) {
+            const T vb = *rb;
+            for (size_t j = 0; j < n; ++j) o[j] = op(ra[j], vb);
+        } else if (step[1] == 0 && step[2] == 1) {
+            const T va = *ra;
+            for (size_t j = 0; j < n; ++j) o[j] = op(va, rb[j]);
+        } else {
+            for (size_t j = 0; j < n; ++j) o[j] = op(ra[j * step[1]], rb[j * step[2]]);
+        }
+    });
+}
+
 template<typename T>
 ndarray<T> broadcast_to(const ndarray<T>& arr, const Shape& target_shape) {
     Shape broadcasted_shape = broadcast_shapes(arr.shape(), target_shape);
     ndarray<T> result(broadcasted_shape);
-    
-    BroadcastIterator<T> it(arr, broadcasted_shape);
-    for (size_t i = 0; i < result.size(); ++i) {
-        result[i] = it.get_value();
-        it.increment();
-    }
-    
+    strided_copy(result.data(), result.strides(), arr.data(), broadcast_strides(arr, broadcasted_shape), broadcasted_shape);
     return result;
 }
 
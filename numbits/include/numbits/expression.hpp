@@ -0,0 +1,238 @@
+#pragma once
+
+#include "ndarray.hpp"
+#include "broadcasting.hpp"
+#include "utils.hpp"
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace numbits {
+
+// Fused element-wise arithmetic. An expression started with lazy() records
+// the operator tree instead of computing intermediate arrays:
+//
+//     ndarray<float> r = lazy(a) * b + lazy(c) * 2.0f - d;
+//
+// evaluates every element of r in one pass with a single allocation. Operands
+// broadcast as in operations.hpp. Named arrays are held by reference and must
+// outlive the expression; temporary arrays are moved into it.
+
+template<typename Derived, typename T>
+class Expression {
+public:
+    using value_type = T;
+    using expression_tag = void;
+
+    size_t size() const { return compute_size(derived().shape()); }
+    size_t ndim() const { return derived().shape().size(); }
+
+    // Writes every element, in row-major order, to out (size() values)
+    void evaluate_into(T* out) const {
+        const Derived& e = derived();
+        const Shape shape = e.shape();
+        const size_t n = compute_size(shape);
+        if (e.same_shape(shape)) {
+            for (size_t i = 0; i < n; ++i) out[i] = e.flat(i);
+            return;
+        }
+        if (n == 0) return;
+        // Broadcasting: walk the outer dimensions, each leaf steps by its own
+        // (possibly zero) stride along the innermost one
+        Derived walk = e;
+        walk.bind(shape);
+        const size_t last = shape.size() - 1;
+        const size_t inner = shape[last];
+        std::vector<size_t> outer(last, 0);
+        for (size_t done = 0; done < n; done += inner) {
+            walk.seek(outer);
+            for (size_t j = 0; j < inner; ++j) out[done + j] = walk.row(j);
+            for (size_t d = last; d-- > 0;) {
+                if (++outer[d] < shape[d]) break;
+                outer[d] = 0;
+            }
+        }
+    }
+
+    // Evaluates into an existing array of the expression's shape, which may be
+    // one of the operands
+    void evaluate_into(ndarray<T>& out) const {
+        const Derived& e = derived();
+        if (e.same_shape(out.shape())) {
+            T* data = out.data();
+            for (size_t i = 0; i < out.size(); ++i) data[i] = e.flat(i);
+            return;
+        }
+        check_output_shape(out.shape(), e.shape());
+        evaluate_into(out.data());
+    }
+
+    ndarray<T> eval() const { return ndarray<T>(derived()); }
+
+private:
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+};
+
+// Leaf reading an ndarray in place (or one it took ownership of)
+template<typename T>
+class ArrayExpr : public Expression<ArrayExpr<T>, T> {
+public:
+    explicit ArrayExpr(const ndarray<T>& arr) : arr_(&arr), row_(arr.data()) {}
+    explicit ArrayExpr(ndarray<T>&& arr)
+        : owned_(std::make_shared<const ndarray<T>>(std::move(arr))), arr_(owned_.get()), row_(arr_->data()) {}
+
+    Shape shape() const { return arr_->shape(); }
+    bool same_shape(const Shape& shape) const { return arr_->shape() == shape; }
+    T flat(size_t i) const { return arr_->data()[i]; }
+
+    void bind(const Shape& target) {
+        strides_ = broadcast_strides(*arr_, target);
+        step_ = strides_.back();
+    }
+    void seek(const std::vector<size_t>& outer) {
+        size_t offset = 0;
+        for (size_t d = 0; d < outer.size(); ++d) offset += outer[d] * strides_[d];
+        row_ = arr_->data() + offset;
+    }
+    T row(size_t j) const { return row_[j * step_]; }
+
+private:
+    std::shared_ptr<const ndarray<T>> owned_; // shared by copies of the tree
+    const ndarray<T>* arr_;
+    Strides strides_;
+    const T* row_;
+    size_t step_{1};
+};
+
+// Leaf broadcasting one value
+template<typename T>
+class ScalarExpr : public Expression<ScalarExpr<T>, T> {
+public:
+    explicit ScalarExpr(T value) : value_(value) {}
+
+    Shape shape() const { return {}; }
+    bool same_shape(const Shape&) const { return true; }
+    T flat(size_t) const { return value_; }
+
+    void bind(const Shape&) {}
+    void seek(const std::vector<size_t>&) {}
+    T row(size_t) const { return value_; }
+
+private:
+    T value_;
+};
+
+template<typename Op, typename L, typename R>
+class BinaryExpr : public Expression<BinaryExpr<Op, L, R>, typename L::value_type> {
+public:
+    using T = typename L::value_type;
+    static_assert(std::is_same_v<T, typename R::value_type>, "Expression operands must have the same element type");
+
+    BinaryExpr(const L& l, const R& r) : l_(l), r_(r) {}
+
+    Shape shape() const { return broadcast_shapes(l_.shape(), r_.shape()); }
+    bool same_shape(const Shape& shape) const { return l_.same_shape(shape) && r_.same_shape(shape); }
+    T flat(size_t i) const { return Op{}(l_.flat(i), r_.flat(i)); }
+
+    void bind(const Shape& target) {
+        l_.bind(target);
+        r_.bind(target);
+    }
+    void seek(const std::vector<size_t>& outer) {
+        l_.seek(outer);
+        r_.seek(outer);
+    }
+    T row(size_t j) const { return Op{}(l_.row(j), r_.row(j)); }
+
+private:
+    L l_;
+    R r_;
+};
+
+template<typename E>
+class NegateExpr : public Expression<NegateExpr<E>, typename E::value_type> {
+public:
+    using T = typename E::value_type;
+
+    explicit NegateExpr(const E& e) : e_(e) {}
+
+    Shape shape() const { return e_.shape(); }
+    bool same_shape(const Shape& shape) const { return e_.same_shape(shape); }
+    T flat(size_t i) const { return -e_.flat(i); }
+
+    void bind(const Shape& target) { e_.bind(target); }
+    void seek(const std::vector<size_t>& outer) { e_.seek(outer); }
+    T row(size_t j) const { return -e_.row(j); }
+
+private:
+    E e_;
+};
+
+// Start a fused expression from an array
+template<typename T>
+ArrayExpr<T> lazy(const ndarray<T>& arr) {
+    return ArrayExpr<T>(arr);
+}
+
+template<typename T>
+ArrayExpr<T> lazy(ndarray<T>&& arr) {
+    return ArrayExpr<T>(std::move(arr));
+}
+
+namespace detail {
+
+template<typename X, typename = void>
+struct is_expression : std::false_type {};
+template<typename X>
+struct is_expression<X, std::void_t<typename X::expression_tag>> : std::true_type {};
+
+template<typename X>
+struct is_ndarray : std::false_type {};
+template<typename T>
+struct is_ndarray<ndarray<T>> : std::true_type {};
+
+// Operators below take over when one side is an expression and the other an
+// expression, an array or a scalar; array-only arithmetic stays eager
+template<typename L, typename R, typename DL = std::decay_t<L>, typename DR = std::decay_t<R>>
+constexpr bool fuses_v =
+    (is_expression<DL>::value && (is_expression<DR>::value || is_ndarray<DR>::value || std::is_arithmetic_v<DR>)) ||
+    (is_expression<DR>::value && (is_ndarray<DL>::value || std::is_arithmetic_v<DL>));
+
+template<typename L, typename R>
+using fused_value_t = typename std::conditional_t<is_expression<L>::value || is_ndarray<L>::value, L, R>::value_type;
+
+template<typename V, typename X>
+auto as_operand(X&& x) {
+    using D = std::decay_t<X>;
+    if constexpr (is_expression<D>::value) return D(std::forward<X>(x));
+    else if constexpr (is_ndarray<D>::value) return ArrayExpr<V>(std::forward<X>(x));
+    else return ScalarExpr<V>(static_cast<V>(x));
+}
+
+template<typename Op, typename L, typename R>
+auto fuse(L&& l, R&& r) {
+    using V = fused_value_t<std::decay_t<L>, std::decay_t<R>>;
+    auto lo = as_operand<V>(std::forward<L>(l));
+    auto ro = as_operand<V>(std::forward<R>(r));
+    return BinaryExpr<Op, decltype(lo), decltype(ro)>(lo, ro);
+}
+
+} // namespace detail
+
+template<typename L, typename R, typename = std::enable_if_t<detail::fuses_v<L, R>>>
+auto operator+(L&& l, R&& r) { return detail::fuse<std::plus<>>(std::forward<L>(l), std::forward<R>(r)); }
+
+template<typename L, typename R, typename = std::enable_if_t<detail::fuses_v<L, R>>>
+auto operator-(L&& l, R&& r) { return detail::fuse<std::minus<>>(std::forward<L>(l), std::forward<R>(r)); }
+
+template<typename L, typename R, typename = std::enable_if_t<detail::fuses_v<L, R>>>
+auto operator*(L&& l, R&& r) { return detail::fuse<std::multiplies<>>(std::forward<L>(l), std::forward<R>(r)); }
+
+template<typename L, typename R, typename = std::enable_if_t<detail::fuses_v<L, R>>>
+auto operator/(L&& l, R&& r) { return detail::fuse<std::divides<>>(std::forward<L>(l), std::forward<R>(r)); }
+
+template<typename E, typename = std::enable_if_t<detail::is_expression<E>::value>>
+NegateExpr<E> operator-(const E& e) { return NegateExpr<E>(e); }
+
+} // namespace numbits
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ndarray.hpp"
+#include "broadcasting.hpp"
+#include "nd_iterator.hpp"
 #include <vector>
 #include <stdexcept>
 
@@ -29,24 +31,16 @@ ndarray<T> take(const ndarray<T>& arr, const std::vector<size_t>& indices, size_
     result_shape[axis] = indices.size();
     ndarray<T> result(result_shape);
     
+    // Each index copies one slab (the axis fixed) from arr into result
+    Shape slab = arr.shape();
+    slab[axis] = 1;
     for (size_t i = 0; i < indices.size(); ++i) {
         size_t idx = indices[i];
         if (idx >= arr.shape()[axis]) {
             throw std::out_of_range("Index out of range");
         }
-        
-        // Copy slice at this index
-        // Simplified: iterate through all elements
-        for (size_t j = 0; j < result.size() / indices.size(); ++j) {
-            // Calculate source and destination indices
-            std::vector<size_t> result_indices = unravel_index(i * (result.size() / indices.size()) + j, 
-                                                                 result_shape, result.strides());
-            std::vector<size_t> arr_indices = result_indices;
-            arr_indices[axis] = idx;
-            size_t arr_idx = flatten_index(arr_indices, arr.strides());
-            size_t result_idx = flatten_index(result_indices, result.strides());
-            result[result_idx] = arr[arr_idx];
-        }
+        strided_copy(result.data() + i * result.strides()[axis], result.strides(),
+                     arr.data() + idx * arr.strides()[axis], arr.strides(), slab);
     }
     
     return result;
@@ -60,15 +54,20 @@ ndarray<T> where(const ndarray<bool>& condition, const ndarray<T>& x, const ndar
     }
     
     Shape broadcast_shape = broadcast_shapes(condition.shape(), x.shape());
-    ndarray<bool> cond_broadcast = broadcast_to(condition, broadcast_shape);
-    ndarray<T> x_broadcast = broadcast_to(x, broadcast_shape);
-    ndarray<T> y_broadcast = broadcast_to(y, broadcast_shape);
-    
     ndarray<T> result(broadcast_shape);
     
-    for (size_t i = 0; i < result.size(); ++i) {
-        result[i] = cond_broadcast[i] ? x_broadcast[i] : y_broadcast[i];
-    }
+    // All three operands are read in place through broadcast strides
+    const bool* pc = condition.data();
+    const T* px = x.data();
+    const T* py = y.data();
+    T* out = result.data();
+    NdIterator<4> it(broadcast_shape, {result.strides(), broadcast_strides(condition, broadcast_shape),
+                                       broadcast_strides(x, broadcast_shape), broadcast_strides(y, broadcast_shape)});
+    it.for_each_run([=](const NdIterator<4>::Offsets& off, size_t n, const NdIterator<4>::Offsets& step) {
+        for (size_t j = 0; j < n; ++j) {
+            out[off[0] + j * step[0]] = pc[off[1] + j * step[1]] ? px[off[2] + j * step[2]] : py[off[3] + j * step[3]];
+        }
+    });
     
     return result;
 }
@@ -1,154 +1,287 @@
 #pragma once
 
 #include "ndarray.hpp"
+#include "utils.hpp"
+#include "simd_math.hpp"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
 
 namespace numbits {
 
-// Mathematical functions
+// Mathematical functions. Each has an overload writing into `out`, which must
+// already have the input's shape and may be the input itself. exp, log, sin,
+// cos and tanh on float and double arrays run the vector kernels of
+// simd_math.hpp.
+template<typename T>
+void abs(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::abs(val); });
+}
+
 template<typename T>
 ndarray<T> abs(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::abs(val); });
+    abs(arr, result);
     return result;
 }
 
+template<typename T>
+void sqrt(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::sqrt(val); });
+}
+
 template<typename T>
 ndarray<T> sqrt(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::sqrt(val); });
+    sqrt(arr, result);
     return result;
 }
 
+template<typename T>
+void pow(const ndarray<T>& arr, T exponent, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [exponent](T val) { return std::pow(val, exponent); });
+}
+
 template<typename T>
 ndarray<T> pow(const ndarray<T>& arr, T exponent) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [exponent](T val) { return std::pow(val, exponent); });
+    pow(arr, exponent, result);
     return result;
 }
 
+template<typename T>
+void exp(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    if constexpr (simd::has_kernels_v<T>) {
+        simd::exp(arr.data(), out.data(), arr.size());
+    } else {
+        std::transform(arr.begin(), arr.end(), out.begin(),
+                       [](T val) { return std::exp(val); });
+    }
+}
+
 template<typename T>
 ndarray<T> exp(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::exp(val); });
+    exp(arr, result);
     return result;
 }
 
+template<typename T>
+void log(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    if constexpr (simd::has_kernels_v<T>) {
+        simd::log(arr.data(), out.data(), arr.size());
+    } else {
+        std::transform(arr.begin(), arr.end(), out.begin(),
+                       [](T val) { return std::log(val); });
+    }
+}
+
 template<typename T>
 ndarray<T> log(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::log(val); });
+    log(arr, result);
     return result;
 }
 
+template<typename T>
+void log10(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::log10(val); });
+}
+
 template<typename T>
 ndarray<T> log10(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::log10(val); });
+    log10(arr, result);
     return result;
 }
 
+template<typename T>
+void sin(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    if constexpr (simd::has_kernels_v<T>) {
+        simd::sin(arr.data(), out.data(), arr.size());
+    } else {
+        std::transform(arr.begin(), arr.end(), out.begin(),
+                       [](T val) { return std::sin(val); });
+    }
+}
+
 template<typename T>
 ndarray<T> sin(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::sin(val); });
+    sin(arr, result);
     return result;
 }
 
+template<typename T>
+void cos(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    if constexpr (simd::has_kernels_v<T>) {
+        simd::cos(arr.data(), out.data(), arr.size());
+    } else {
+        std::transform(arr.begin(), arr.end(), out.begin(),
+                       [](T val) { return std::cos(val); });
+    }
+}
+
 template<typename T>
 ndarray<T> cos(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::cos(val); });
+    cos(arr, result);
     return result;
 }
 
+template<typename T>
+void tan(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::tan(val); });
+}
+
 template<typename T>
 ndarray<T> tan(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::tan(val); });
+    tan(arr, result);
     return result;
 }
 
+template<typename T>
+void asin(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::asin(val); });
+}
+
 template<typename T>
 ndarray<T> asin(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::asin(val); });
+    asin(arr, result);
     return result;
 }
 
+template<typename T>
+void acos(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::acos(val); });
+}
+
 template<typename T>
 ndarray<T> acos(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::acos(val); });
+    acos(arr, result);
     return result;
 }
 
+template<typename T>
+void atan(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::atan(val); });
+}
+
 template<typename T>
 ndarray<T> atan(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::atan(val); });
+    atan(arr, result);
     return result;
 }
 
+template<typename T>
+void sinh(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::sinh(val); });
+}
+
 template<typename T>
 ndarray<T> sinh(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::sinh(val); });
+    sinh(arr, result);
     return result;
 }
 
+template<typename T>
+void cosh(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::cosh(val); });
+}
+
 template<typename T>
 ndarray<T> cosh(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::cosh(val); });
+    cosh(arr, result);
     return result;
 }
 
+template<typename T>
+void tanh(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    if constexpr (simd::has_kernels_v<T>) {
+        simd::tanh(arr.data(), out.data(), arr.size());
+    } else {
+        std::transform(arr.begin(), arr.end(), out.begin(),
+                       [](T val) { return std::tanh(val); });
+    }
+}
+
 template<typename T>
 ndarray<T> tanh(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::tanh(val); });
+    tanh(arr, result);
     return result;
 }
 
+template<typename T>
+void ceil(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::ceil(val); });
+}
+
 template<typename T>
 ndarray<T> ceil(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::ceil(val); });
+    ceil(arr, result);
     return result;
 }
 
+template<typename T>
+void floor(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::floor(val); });
+}
+
 template<typename T>
 ndarray<T> floor(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::floor(val); });
+    floor(arr, result);
     return result;
 }
 
+template<typename T>
+void round(const ndarray<T>& arr, ndarray<T>& out) {
+    check_output_shape(out.shape(), arr.shape());
+    std::transform(arr.begin(), arr.end(), out.begin(),
+                   [](T val) { return std::round(val); });
+}
+
 template<typename T>
 ndarray<T> round(const ndarray<T>& arr) {
     ndarray<T> result(arr.shape());
-    std::transform(arr.begin(), arr.end(), result.begin(),
-                   [](T val) { return std::round(val); });
+    round(arr, result);
     return result;
 }
 
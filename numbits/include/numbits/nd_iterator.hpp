@@ -0,0 +1,118 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace numbits {
+
+// Iteration engine shared by broadcasting, where, take, tile and concatenate.
+// Walks `shape` for K operands at once, each with its own element strides
+// (stride 0 revisits the same element, which is how broadcasting is done).
+// Size-1 dimensions are dropped and adjacent dimensions that are contiguous
+// for every operand are merged, so a same-layout N-d walk becomes one run.
+// Offsets are advanced incrementally; the innermost dimension is handed to
+// the kernel as a single 1-D loop. All bookkeeping lives inline, so setting
+// up a walk does not allocate.
+constexpr size_t kMaxIterDims = 32;
+
+template<size_t K>
+class NdIterator {
+public:
+    using Offsets = std::array<size_t, K>;
+
+    NdIterator(const Shape& shape, const std::array<Strides, K>& strides)
+        : NdIterator(shape, [&strides](size_t k, size_t d) { return strides[k][d]; }) {}
+
+    // stride(k, d) gives operand k's element stride along dimension d, so
+    // callers can derive strides on the fly instead of building vectors
+    template<typename StrideFn>
+    NdIterator(const Shape& shape, StrideFn stride) {
+        for (size_t d = 0; d < shape.size(); ++d) {
+            if (shape[d] == 0) {
+                empty_ = true;
+                return;
+            }
+            if (shape[d] == 1) continue;
+            // Merge into the previous dimension when it steps exactly over this one
+            if (ndim_ > 0 && mergeable(stride, d, shape[d])) {
+                shape_[ndim_ - 1] *= shape[d];
+                for (size_t k = 0; k < K; ++k) strides_[k][ndim_ - 1] = stride(k, d);
+                continue;
+            }
+            if (ndim_ == kMaxIterDims) throw std::runtime_error("Too many dimensions to iterate");
+            shape_[ndim_] = shape[d];
+            for (size_t k = 0; k < K; ++k) strides_[k][ndim_] = stride(k, d);
+            ++ndim_;
+        }
+    }
+
+    // Dimensions left after collapsing (0 for a single element)
+    size_t ndim() const { return ndim_; }
+
+    // Calls run(offsets, count, inner_strides) for every innermost run, where
+    // operand k visits offsets[k] + j * inner_strides[k] for j in [0, count)
+    template<typename F>
+    void for_each_run(F&& run) const {
+        if (empty_) return;
+        Offsets offsets{};
+        if (ndim_ == 0) {
+            Offsets unit{};
+            run(offsets, size_t(1), unit);
+            return;
+        }
+        const size_t last = ndim_ - 1;
+        const size_t inner = shape_[last];
+        Offsets inner_strides;
+        for (size_t k = 0; k < K; ++k) inner_strides[k] = strides_[k][last];
+        std::array<size_t, kMaxIterDims> index{};
+        for (;;) {
+            run(offsets, inner, inner_strides);
+            size_t d = last;
+            for (; d-- > 0;) {
+                for (size_t k = 0; k < K; ++k) offsets[k] += strides_[k][d];
+                if (++index[d] < shape_[d]) break;
+                for (size_t k = 0; k < K; ++k) offsets[k] -= strides_[k][d] * shape_[d];
+                index[d] = 0;
+            }
+            if (d == static_cast<size_t>(-1)) return; // outermost index wrapped
+        }
+    }
+
+private:
+    // True when, for every operand, one step of the previous kept dimension
+    // equals a full sweep of dimension d
+    template<typename StrideFn>
+    bool mergeable(StrideFn& stride, size_t d, size_t extent) const {
+        for (size_t k = 0; k < K; ++k) {
+            if (strides_[k][ndim_ - 1] != stride(k, d) * extent) return false;
+        }
+        return true;
+    }
+
+    std::array<size_t, kMaxIterDims> shape_;
+    std::array<std::array<size_t, kMaxIterDims>, K> strides_;
+    size_t ndim_{0};
+    bool empty_{false};
+};
+
+// dst[i] = src[i] over `shape`, both read through their own element strides
+template<typename T>
+void strided_copy(T* dst, const Strides& dst_strides, const T* src, const Strides& src_strides, const Shape& shape) {
+    NdIterator<2> it(shape, {dst_strides, src_strides});
+    it.for_each_run([dst, src](const NdIterator<2>::Offsets& off, size_t n, const NdIterator<2>::Offsets& step) {
+        T* d = dst + off[0];
+        const T* s = src + off[1];
+        if (step[0] == 1 && step[1] == 1) {
+            std::copy(s, s + n, d);
+        } else if (step[0] == 1 && step[1] == 0) {
+            std::fill(d, d + n, *s);
+        } else {
+            for (size_t j = 0; j < n; ++j) d[j * step[0]] = s[j * step[1]];
+        }
+    });
+}
+
+} // namespace numbits
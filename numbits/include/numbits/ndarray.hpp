@@ -54,6 +54,16 @@ public:
     ndarray(const Shape& shape, std::initializer_list<T> data)
         : ndarray(shape, std::vector<T>(data)) {}
 
+    // Evaluate a fused expression (see expression.hpp) in one pass
+    template<typename E, typename = typename E::expression_tag>
+    ndarray(const E& expr)
+        : shape_(expr.shape()), strides_(compute_strides(shape_)),
+          size_(compute_size(shape_)), owns_data_(true) {
+        static_assert(std::is_same_v<typename E::value_type, T>, "Expression element type does not match the array");
+        data_ = size_ > 0 ? new T[size_] : nullptr;
+        if (size_ > 0) expr.evaluate_into(data_);
+    }
+
     // Copy constructor
     ndarray(const ndarray& other)
         : shape_(other.shape_), strides_(other.strides_), 
@@ -85,6 +95,13 @@ public:
     // Assignment operators
     ndarray& operator=(const ndarray& other) {
         if (this != &other) {
+            // Same element count: copy into the existing buffer
+            if (owns_data_ && size_ == other.size_) {
+                shape_ = other.shape_;
+                strides_ = other.strides_;
+                std::copy(other.data_, other.data_ + size_, data_);
+                return *this;
+            }
             if (owns_data_ && data_) {
                 delete[] data_;
             }
@@ -119,6 +136,18 @@ public:
         return *this;
     }
 
+    template<typename E, typename = typename E::expression_tag>
+    ndarray& operator=(const E& expr) {
+        // Same shape: evaluate into the existing buffer. Element-wise trees read
+        // each element before writing it, so the expression may read this array
+        if (owns_data_ && (expr.same_shape(shape_) || expr.shape() == shape_)) {
+            expr.evaluate_into(*this);
+            return *this;
+        }
+        // Otherwise evaluate before replacing the buffer
+        return *this = ndarray(expr);
+    }
+
     // Accessors
     const Shape& shape() const { return shape_; }
     const Strides& strides() const { return strides_; }
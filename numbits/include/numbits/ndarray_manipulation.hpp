@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ndarray.hpp"
+#include "nd_iterator.hpp"
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
@@ -46,27 +47,12 @@ ndarray<T> concatenate(const std::vector<ndarray<T>>& ndarrays, size_t axis = 0)
     // Create result ndarray
     ndarray<T> result(result_shape);
     
-    // Copy data
+    // Copy each input into its block of the result
     size_t result_offset = 0;
     for (const auto& arr : ndarrays) {
-        size_t axis_size = arr.shape()[axis];
-        
-        // Copy each element
-        for (size_t i = 0; i < arr.size(); ++i) {
-            // Calculate position in source ndarray
-            std::vector<size_t> src_indices = unravel_index(i, arr.shape(), arr.strides());
-            
-            // Calculate position in result ndarray (adjust axis)
-            std::vector<size_t> dst_indices = src_indices;
-            dst_indices[axis] += result_offset;
-            
-            // Copy element
-            size_t dst_idx = flatten_index(dst_indices, result.strides());
-            if (dst_idx < result.size()) {
-                result[dst_idx] = arr[i];
-            }
-        }
-        result_offset += axis_size;
+        strided_copy(result.data() + result_offset * result.strides()[axis], result.strides(),
+                     arr.data(), arr.strides(), arr.shape());
+        result_offset += arr.shape()[axis];
     }
     
     return result;
@@ -217,15 +203,19 @@ ndarray<T> tile(const ndarray<T>& arr, const std::vector<size_t>& reps) {
     
     ndarray<T> result(result_shape);
     
-    for (size_t i = 0; i < result.size(); ++i) {
-        std::vector<size_t> result_indices = unravel_index(i, result_shape, result.strides());
-        std::vector<size_t> arr_indices = result_indices;
-        for (size_t j = 0; j < arr_indices.size(); ++j) {
-            arr_indices[j] %= arr.shape()[j];
-        }
-        size_t arr_idx = flatten_index(arr_indices, arr.strides());
-        result[i] = arr[arr_idx];
-    }
+    // Split every dimension into (repetition, element): the source does not
+    // move along repetitions, so it is read through stride 0 there
+    Shape split_shape;
+    Strides dst_strides, src_strides;
+    for (size_t i = 0; i < reps.size(); ++i) {
+        split_shape.push_back(reps[i]);
+        split_shape.push_back(arr.shape()[i]);
+        dst_strides.push_back(arr.shape()[i] * result.strides()[i]);
+        dst_strides.push_back(result.strides()[i]);
+        src_strides.push_back(0);
+        src_strides.push_back(arr.strides()[i]);
+    }
+    strided_copy(result.data(), dst_strides, arr.data(), src_strides, split_shape);
     
     return result;
 }
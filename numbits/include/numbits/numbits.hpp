@@ -6,8 +6,11 @@
 #include "numbits/types.hpp"
 #include "numbits/utils.hpp"
 #include "numbits/operations.hpp"
+#include "numbits/expression.hpp"
 #include "numbits/broadcasting.hpp"
+#include "numbits/nd_iterator.hpp"
 #include "numbits/math_functions.hpp"
+#include "numbits/simd_math.hpp"
 #include "numbits/linear_algebra.hpp"
 #include "numbits/ndarray_manipulation.hpp"
 #include "numbits/indexing.hpp"
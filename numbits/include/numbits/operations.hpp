@@ -9,97 +9,158 @@
 
 namespace numbits {
 
-// Element-wise operations
+// Element-wise operations. The overloads taking `out` write the result into
+// an existing array instead of allocating; it must already have the result
+// shape and may alias either operand.
+template<typename T>
+void add(const ndarray<T>& a, const ndarray<T>& b, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::plus<T>());
+}
+
 template<typename T>
 ndarray<T> add(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<T> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::plus<T>());
-    
+    ndarray<T> result(broadcast_shapes(a.shape(), b.shape()));
+    add(a, b, result);
     return result;
 }
 
+template<typename T>
+void subtract(const ndarray<T>& a, const ndarray<T>& b, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::minus<T>());
+}
+
 template<typename T>
 ndarray<T> subtract(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<T> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::minus<T>());
-    
+    ndarray<T> result(broadcast_shapes(a.shape(), b.shape()));
+    subtract(a, b, result);
     return result;
 }
 
+template<typename T>
+void multiply(const ndarray<T>& a, const ndarray<T>& b, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::multiplies<T>());
+}
+
 template<typename T>
 ndarray<T> multiply(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<T> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::multiplies<T>());
-    
+    ndarray<T> result(broadcast_shapes(a.shape(), b.shape()));
+    multiply(a, b, result);
     return result;
 }
 
+template<typename T>
+void divide(const ndarray<T>& a, const ndarray<T>& b, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::divides<T>());
+}
+
 template<typename T>
 ndarray<T> divide(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<T> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::divides<T>());
-    
+    ndarray<T> result(broadcast_shapes(a.shape(), b.shape()));
+    divide(a, b, result);
     return result;
 }
 
 // Scalar operations
+template<typename T>
+void add_scalar(const ndarray<T>& a, T scalar, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape());
+    std::transform(a.begin(), a.end(), out.begin(),
+                   [scalar](T val) { return val + scalar; });
+}
+
 template<typename T>
 ndarray<T> add_scalar(const ndarray<T>& a, T scalar) {
     ndarray<T> result(a.shape());
-    std::transform(a.begin(), a.end(), result.begin(),
-                   [scalar](T val) { return val + scalar; });
+    add_scalar(a, scalar, result);
     return result;
 }
 
+template<typename T>
+void subtract_scalar(const ndarray<T>& a, T scalar, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape());
+    std::transform(a.begin(), a.end(), out.begin(),
+                   [scalar](T val) { return val - scalar; });
+}
+
 template<typename T>
 ndarray<T> subtract_scalar(const ndarray<T>& a, T scalar) {
     ndarray<T> result(a.shape());
-    std::transform(a.begin(), a.end(), result.begin(),
-                   [scalar](T val) { return val - scalar; });
+    subtract_scalar(a, scalar, result);
     return result;
 }
 
+template<typename T>
+void multiply_scalar(const ndarray<T>& a, T scalar, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape());
+    std::transform(a.begin(), a.end(), out.begin(),
+                   [scalar](T val) { return val * scalar; });
+}
+
 template<typename T>
 ndarray<T> multiply_scalar(const ndarray<T>& a, T scalar) {
     ndarray<T> result(a.shape());
-    std::transform(a.begin(), a.end(), result.begin(),
-                   [scalar](T val) { return val * scalar; });
+    multiply_scalar(a, scalar, result);
     return result;
 }
 
+template<typename T>
+void divide_scalar(const ndarray<T>& a, T scalar, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape());
+    std::transform(a.begin(), a.end(), out.begin(),
+                   [scalar](T val) { return val / scalar; });
+}
+
 template<typename T>
 ndarray<T> divide_scalar(const ndarray<T>& a, T scalar) {
     ndarray<T> result(a.shape());
-    std::transform(a.begin(), a.end(), result.begin(),
-                   [scalar](T val) { return val / scalar; });
+    divide_scalar(a, scalar, result);
+    return result;
+}
+
+// Scalar on the left: scalar - a and scalar / a
+template<typename T>
+void rsubtract_scalar(const ndarray<T>& a, T scalar, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape());
+    std::transform(a.begin(), a.end(), out.begin(),
+                   [scalar](T val) { return scalar - val; });
+}
+
+template<typename T>
+ndarray<T> rsubtract_scalar(const ndarray<T>& a, T scalar) {
+    ndarray<T> result(a.shape());
+    rsubtract_scalar(a, scalar, result);
+    return result;
+}
+
+template<typename T>
+void rdivide_scalar(const ndarray<T>& a, T scalar, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape());
+    std::transform(a.begin(), a.end(), out.begin(),
+                   [scalar](T val) { return scalar / val; });
+}
+
+template<typename T>
+ndarray<T> rdivide_scalar(const ndarray<T>& a, T scalar) {
+    ndarray<T> result(a.shape());
+    rdivide_scalar(a, scalar, result);
+    return result;
+}
+
+template<typename T>
+void negative(const ndarray<T>& a, ndarray<T>& out) {
+    check_output_shape(out.shape(), a.shape());
+    std::transform(a.begin(), a.end(), out.begin(),
+                   [](T val) { return -val; });
+}
+
+template<typename T>
+ndarray<T> negative(const ndarray<T>& a) {
+    ndarray<T> result(a.shape());
+    negative(a, result);
     return result;
 }
 
@@ -141,18 +202,12 @@ ndarray<T> operator-(const ndarray<T>& a, T scalar) {
 
 template<typename T>
 ndarray<T> operator-(T scalar, const ndarray<T>& a) {
-    ndarray<T> result(a.shape());
-    std::transform(a.begin(), a.end(), result.begin(),
-                   [scalar](T val) { return scalar - val; });
-    return result;
+    return rsubtract_scalar(a, scalar);
 }
 
 template<typename T>
 ndarray<T> operator-(const ndarray<T>& a) {
-    ndarray<T> result(a.shape());
-    std::transform(a.begin(), a.end(), result.begin(),
-                   [](T val) { return -val; });
-    return result;
+    return negative(a);
 }
 
 template<typename T>
@@ -172,100 +227,135 @@ ndarray<T> operator/(const ndarray<T>& a, T scalar) {
 
 template<typename T>
 ndarray<T> operator/(T scalar, const ndarray<T>& a) {
-    ndarray<T> result(a.shape());
-    std::transform(a.begin(), a.end(), result.begin(),
-                   [scalar](T val) { return scalar / val; });
-    return result;
+    return rdivide_scalar(a, scalar);
+}
+
+// Compound assignment updates the left operand in place. The right operand
+// may broadcast, but the result must keep the left operand's shape.
+template<typename T>
+ndarray<T>& operator+=(ndarray<T>& a, const ndarray<T>& b) {
+    add(a, b, a);
+    return a;
+}
+
+template<typename T>
+ndarray<T>& operator-=(ndarray<T>& a, const ndarray<T>& b) {
+    subtract(a, b, a);
+    return a;
+}
+
+template<typename T>
+ndarray<T>& operator*=(ndarray<T>& a, const ndarray<T>& b) {
+    multiply(a, b, a);
+    return a;
+}
+
+template<typename T>
+ndarray<T>& operator/=(ndarray<T>& a, const ndarray<T>& b) {
+    divide(a, b, a);
+    return a;
+}
+
+template<typename T>
+ndarray<T>& operator+=(ndarray<T>& a, T scalar) {
+    add_scalar(a, scalar, a);
+    return a;
+}
+
+template<typename T>
+ndarray<T>& operator-=(ndarray<T>& a, T scalar) {
+    subtract_scalar(a, scalar, a);
+    return a;
+}
+
+template<typename T>
+ndarray<T>& operator*=(ndarray<T>& a, T scalar) {
+    multiply_scalar(a, scalar, a);
+    return a;
+}
+
+template<typename T>
+ndarray<T>& operator/=(ndarray<T>& a, T scalar) {
+    divide_scalar(a, scalar, a);
+    return a;
 }
 
 // Comparison operations
+template<typename T>
+void equal(const ndarray<T>& a, const ndarray<T>& b, ndarray<bool>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::equal_to<T>());
+}
+
 template<typename T>
 ndarray<bool> equal(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<bool> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::equal_to<T>());
-    
+    ndarray<bool> result(broadcast_shapes(a.shape(), b.shape()));
+    equal(a, b, result);
     return result;
 }
 
+template<typename T>
+void not_equal(const ndarray<T>& a, const ndarray<T>& b, ndarray<bool>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::not_equal_to<T>());
+}
+
 template<typename T>
 ndarray<bool> not_equal(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<bool> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::not_equal_to<T>());
-    
+    ndarray<bool> result(broadcast_shapes(a.shape(), b.shape()));
+    not_equal(a, b, result);
     return result;
 }
 
+template<typename T>
+void less(const ndarray<T>& a, const ndarray<T>& b, ndarray<bool>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::less<T>());
+}
+
 template<typename T>
 ndarray<bool> less(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<bool> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::less<T>());
-    
+    ndarray<bool> result(broadcast_shapes(a.shape(), b.shape()));
+    less(a, b, result);
     return result;
 }
 
+template<typename T>
+void greater(const ndarray<T>& a, const ndarray<T>& b, ndarray<bool>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::greater<T>());
+}
+
 template<typename T>
 ndarray<bool> greater(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<bool> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::greater<T>());
-    
+    ndarray<bool> result(broadcast_shapes(a.shape(), b.shape()));
+    greater(a, b, result);
     return result;
 }
 
+template<typename T>
+void less_equal(const ndarray<T>& a, const ndarray<T>& b, ndarray<bool>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::less_equal<T>());
+}
+
 template<typename T>
 ndarray<bool> less_equal(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<bool> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::less_equal<T>());
-    
+    ndarray<bool> result(broadcast_shapes(a.shape(), b.shape()));
+    less_equal(a, b, result);
     return result;
 }
 
+template<typename T>
+void greater_equal(const ndarray<T>& a, const ndarray<T>& b, ndarray<bool>& out) {
+    check_output_shape(out.shape(), a.shape(), b.shape());
+    broadcast_apply(a, b, out, std::greater_equal<T>());
+}
+
 template<typename T>
 ndarray<bool> greater_equal(const ndarray<T>& a, const ndarray<T>& b) {
-    Shape result_shape = broadcast_shapes(a.shape(), b.shape());
-    ndarray<bool> result(result_shape);
-    
-    ndarray<T> a_broadcast = broadcast_to(a, result_shape);
-    ndarray<T> b_broadcast = broadcast_to(b, result_shape);
-    
-    std::transform(a_broadcast.begin(), a_broadcast.end(), 
-                   b_broadcast.begin(), result.begin(),
-                   std::greater_equal<T>());
-    
+    ndarray<bool> result(broadcast_shapes(a.shape(), b.shape()));
+    greater_equal(a, b, result);
     return result;
 }
 
@@ -0,0 +1,328 @@
+// Vector kernels behind simd_math.hpp. This file is included once per
+// instruction set, inside a namespace compiled for that target which defines
+// kVectorBytes, so it deliberately has no include guard.
+
+// W lanes of T and the matching unsigned bit pattern
+template<typename T, size_t W>
+struct Pack {
+    using Scalar = T;
+    using UInt = typename FloatBits<T>::UInt;
+    typedef T V __attribute__((vector_size(sizeof(T) * W)));
+    typedef UInt U __attribute__((vector_size(sizeof(T) * W)));
+    typedef std::make_signed_t<UInt> M __attribute__((vector_size(sizeof(T) * W))); // lane masks
+    static constexpr size_t kWidth = W;
+
+    static V splat(T c) { return V{} + c; }
+
+    static V load(const T* p) {
+        V v;
+        std::memcpy(&v, p, sizeof(V));
+        return v;
+    }
+
+    static void store(T* p, V v) { std::memcpy(p, &v, sizeof(V)); }
+
+    static bool any(M m) {
+        uint64_t words[sizeof(M) / sizeof(uint64_t)];
+        std::memcpy(words, &m, sizeof(M));
+        uint64_t acc = 0;
+        for (uint64_t w : words) acc |= w;
+        return acc != 0;
+    }
+
+    static V abs(V x) { return (V)((U)x & ~(U{} + (UInt(1) << (sizeof(T) * 8 - 1)))); }
+
+    // Nearest integer, for |x| < 2^22 (float) or 2^51 (double)
+    static V round(V x) {
+        const V shifter = splat(FloatBits<T>::kShifter);
+        return (x + shifter) - shifter;
+    }
+
+    // 2^n for integral n within the normal exponent range
+    static V pow2(V n) {
+        const U biased = (U)(n + splat(FloatBits<T>::kShifter + FloatBits<T>::kBias));
+        return (V)(biased << FloatBits<T>::kMantissaBits);
+    }
+
+    // Splits a positive normal x into m * 2^e with m in [0.5, 1)
+    static V frexp(V x, V& e) {
+        const U bits = (U)x;
+        const U exponent = bits >> FloatBits<T>::kMantissaBits;
+        const U two_pow_mantissa = (U)splat(T(1) * (UInt(1) << FloatBits<T>::kMantissaBits));
+        const V biased = (V)(exponent | two_pow_mantissa) - (V)two_pow_mantissa;
+        e = biased - splat(FloatBits<T>::kBias - 1);
+        return (V)((bits & FloatBits<T>::kMantissaMask) | (U)splat(T(0.5)));
+    }
+
+    // Lane mask of (k & bit) != 0 for integral 0 <= k < 2^22
+    static M bit_set(V k, UInt bit) {
+        const U bits = (U)(k + splat(FloatBits<T>::kShifter));
+        return (bits & bit) != 0;
+    }
+};
+
+// Each kernel provides eval(), valid for lanes where outside() is false; the
+// other lanes take the std:: result
+template<Function F>
+struct Kernel;
+
+template<>
+struct Kernel<Function::Exp> {
+    template<typename P>
+    static typename P::M outside(typename P::V x) {
+        using T = typename P::Scalar;
+        constexpr T lo = std::is_same_v<T, float> ? T(-87) : T(-708);
+        constexpr T hi = std::is_same_v<T, float> ? T(88) : T(709);
+        return ~((x >= lo) & (x <= hi));
+    }
+
+    template<typename P>
+    static typename P::V eval(typename P::V x) {
+        using T = typename P::Scalar;
+        using V = typename P::V;
+        const V n = P::round(x * P::splat(T(1.44269504088896341)));
+        if constexpr (std::is_same_v<T, float>) {
+            V r = x - n * 0.693359375f;
+            r = r - n * -2.12194440e-4f;
+            const V z = r * r;
+            V p = P::splat(1.9875691500e-4f);
+            p = p * r + 1.3981999507e-3f;
+            p = p * r + 8.3334519073e-3f;
+            p = p * r + 4.1665795894e-2f;
+            p = p * r + 1.6666665459e-1f;
+            p = p * r + 5.0000001201e-1f;
+            p = p * z + r + 1.0f;
+            return p * P::pow2(n);
+        } else {
+            V r = x - n * 6.93145751953125e-1;
+            r = r - n * 1.42860682030941723212e-6;
+            const V rr = r * r;
+            V px = P::splat(1.26177193074810590878e-4);
+            px = px * rr + 3.02994407707441961300e-2;
+            px = (px * rr + 9.99999999999999999910e-1) * r;
+            V q = P::splat(3.00198505138664455042e-6);
+            q = q * rr + 2.52448340349684104192e-3;
+            q = q * rr + 2.27265548208155028766e-1;
+            q = q * rr + 2.00000000000000000009e0;
+            const V e = px / (q - px);
+            return (e + e + 1.0) * P::pow2(n);
+        }
+    }
+};
+
+template<>
+struct Kernel<Function::Log> {
+    template<typename P>
+    static typename P::M outside(typename P::V x) {
+        using T = typename P::Scalar;
+        return ~((x >= std::numeric_limits<T>::min()) & (x <= std::numeric_limits<T>::max()));
+    }
+
+    template<typename P>
+    static typename P::V eval(typename P::V x) {
+        using T = typename P::Scalar;
+        using V = typename P::V;
+        V e;
+        V m = P::frexp(x, e);
+        const auto small = m < T(0.707106781186547524);
+        e = small ? e - T(1) : e;
+        m = (small ? m + m : m) - T(1);
+        const V z = m * m;
+        V y;
+        if constexpr (std::is_same_v<T, float>) {
+            y = P::splat(7.0376836292e-2f);
+            y = y * m - 1.1514610310e-1f;
+            y = y * m + 1.1676998740e-1f;
+            y = y * m - 1.2420140846e-1f;
+            y = y * m + 1.4249322787e-1f;
+            y = y * m - 1.6668057665e-1f;
+            y = y * m + 2.0000714765e-1f;
+            y = y * m - 2.4999993993e-1f;
+            y = y * m + 3.3333331174e-1f;
+            y = y * m * z;
+        } else {
+            V p = P::splat(1.01875663804580931796e-4);
+            p = p * m + 4.97494994976747001425e-1;
+            p = p * m + 4.70579119878881725854e0;
+            p = p * m + 1.44989225341610930846e1;
+            p = p * m + 1.79368678507819816313e1;
+            p = p * m + 7.70838733755885391666e0;
+            V q = m + 1.12873587189167450590e1;
+            q = q * m + 4.52279145837532221105e1;
+            q = q * m + 8.29875266912776603211e1;
+            q = q * m + 7.11544750618563894466e1;
+            q = q * m + 2.31251620126765340583e1;
+            y = m * (z * p / q);
+        }
+        y = y - e * T(2.121944400546905827679e-4);
+        y = y - z * T(0.5);
+        return (m + y) + e * T(0.693359375);
+    }
+};
+
+// sin and cos share the reduction r = |x| - k * pi/2, with pi/2 split in three
+// parts so the first products are exact
+template<bool Cosine>
+struct SinCosKernel {
+    template<typename P>
+    static typename P::V reduce(typename P::V ax, typename P::V k) {
+        return ((ax - k * 1.57079625129699707031e0) - k * 7.54978941586159635336e-8) - k * 5.39030285815811905290e-15;
+    }
+
+    template<typename P>
+    static typename P::M outside(typename P::V x) {
+        using T = typename P::Scalar;
+        using V = typename P::V;
+        const V ax = P::abs(x);
+        const auto out = ~(ax <= T(16777216));
+        if constexpr (std::is_same_v<T, float>) {
+            return out;
+        } else {
+            // The reduction leaves an absolute error of about k * 2^-99 in r.
+            // Near a multiple of pi/2 that is no longer small next to r, so
+            // those lanes take the std:: result as well
+            const V k = P::round(ax * P::splat(T(0.636619772367581343076)));
+            return out | (P::abs(reduce<P>(ax, k)) < k * T(0x1p-40));
+        }
+    }
+
+    template<typename P>
+    static typename P::V eval(typename P::V x) {
+        using T = typename P::Scalar;
+        // Near multiples of pi the float reduction loses most of r, so float
+        // lanes go through the double kernel, in two native-width halves, and
+        // are rounded once at the end
+        if constexpr (std::is_same_v<T, float>) {
+            using PD = Pack<double, P::kWidth / 2>;
+            float lanes[P::kWidth];
+            double wide[P::kWidth];
+            P::store(lanes, x);
+            std::copy(lanes, lanes + P::kWidth, wide);
+            PD::store(wide, eval_f64<PD>(PD::load(wide)));
+            PD::store(wide + PD::kWidth, eval_f64<PD>(PD::load(wide + PD::kWidth)));
+            std::copy(wide, wide + P::kWidth, lanes);
+            return P::load(lanes);
+        } else {
+            return eval_f64<P>(x);
+        }
+    }
+
+    template<typename P>
+    static typename P::V eval_f64(typename P::V x) {
+        using T = typename P::Scalar;
+        using V = typename P::V;
+        const V ax = P::abs(x);
+        const V k = P::round(ax * P::splat(T(0.636619772367581343076)));
+        const V r = reduce<P>(ax, k);
+        const V z = r * r;
+        V s = P::splat(1.58962301576546568060e-10);
+        s = s * z - 2.50507477628578072866e-8;
+        s = s * z + 2.75573136213857245213e-6;
+        s = s * z - 1.98412698295895385996e-4;
+        s = s * z + 8.33333333332211858878e-3;
+        s = s * z - 1.66666666666666307295e-1;
+        s = r + r * z * s;
+        V c = P::splat(-1.13585365213876817300e-11);
+        c = c * z + 2.08757008419747316778e-9;
+        c = c * z - 2.75573141792967388112e-7;
+        c = c * z + 2.48015872888517045348e-5;
+        c = c * z - 1.38888888888730564116e-3;
+        c = c * z + 4.16666666666665929218e-2;
+        c = T(1) - z * T(0.5) + z * z * c;
+        // Odd quadrants swap the polynomials
+        const auto odd = P::bit_set(k, 1);
+        if constexpr (Cosine) {
+            const V v = odd ? s : c;
+            return P::bit_set(k + T(1), 2) ? -v : v;
+        } else {
+            const V v = odd ? c : s;
+            const auto flip = P::bit_set(k, 2) ^ (x < T(0));
+            const V signed_v = flip ? -v : v;
+            return x == T(0) ? x : signed_v; // keeps the sign of -0
+        }
+    }
+};
+
+template<>
+struct Kernel<Function::Sin> : SinCosKernel<false> {};
+
+template<>
+struct Kernel<Function::Cos> : SinCosKernel<true> {};
+
+template<>
+struct Kernel<Function::Tanh> {
+    template<typename P>
+    static typename P::M outside(typename P::V x) { return x != x; }
+
+    template<typename P>
+    static typename P::V eval(typename P::V x) {
+        using T = typename P::Scalar;
+        using V = typename P::V;
+        const V ax = P::abs(x);
+        const V z = x * x;
+        V small;
+        if constexpr (std::is_same_v<T, float>) {
+            small = P::splat(-5.70498872745e-3f);
+            small = small * z + 2.06390887954e-2f;
+            small = small * z - 5.37397155531e-2f;
+            small = small * z + 1.33314422036e-1f;
+            small = small * z - 3.33332819422e-1f;
+            small = small * z * x + x;
+        } else {
+            V p = P::splat(-9.64399179425052238628e-1);
+            p = p * z - 9.92877231001918586564e1;
+            p = p * z - 1.61468768441708447952e3;
+            V q = z + 1.12811678491632931402e2;
+            q = q * z + 2.23548839060100448583e3;
+            q = q * z + 4.84406305325125486048e3;
+            small = x + x * (z * p / q);
+        }
+        // tanh(20) rounds to 1 in both precisions, which keeps exp in range
+        const V clamped = ax < T(20) ? ax : P::splat(T(20));
+        const V t = Kernel<Function::Exp>::eval<P>(clamped + clamped);
+        V large = T(1) - T(2) / (t + T(1));
+        large = x < T(0) ? -large : large;
+        return ax < T(0.625) ? small : large;
+    }
+};
+
+// Lanes outside the kernel's domain are patched with the std:: result
+template<Function F, typename P>
+void map_block(const typename P::Scalar* in, typename P::Scalar* out) {
+    using T = typename P::Scalar;
+    using V = typename P::V;
+    const V x = P::load(in);
+    const V y = Kernel<F>::template eval<P>(x);
+    const auto bad = Kernel<F>::template outside<P>(x);
+    if (!P::any(bad)) {
+        P::store(out, y);
+        return;
+    }
+    T lanes[P::kWidth];
+    P::store(lanes, y);
+    for (size_t j = 0; j < P::kWidth; ++j) {
+        if (bad[j]) lanes[j] = reference<F>(in[j]);
+    }
+    std::memcpy(out, lanes, sizeof(lanes));
+}
+
+template<Function F, typename P>
+void map_lanes(const typename P::Scalar* in, typename P::Scalar* out, size_t n) {
+    using T = typename P::Scalar;
+    constexpr size_t W = P::kWidth;
+    size_t i = 0;
+    for (; i + W <= n; i += W) map_block<F, P>(in + i, out + i);
+    if (i < n) {
+        // The tail runs through the same kernel so results do not depend on position
+        T buf[W];
+        std::fill(buf, buf + W, T(1));
+        std::copy(in + i, in + n, buf);
+        map_block<F, P>(buf, buf);
+        std::copy(buf, buf + (n - i), out + i);
+    }
+}
+
+template<Function F, typename T>
+void map(const T* in, T* out, size_t n) {
+    map_lanes<F, Pack<T, kVectorBytes / sizeof(T)>>(in, out, n);
+}
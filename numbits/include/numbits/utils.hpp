@@ -80,5 +80,26 @@ inline std::string shape_to_string(const Shape& shape) {
     return oss.str();
 }
 
+// Out-parameter overloads write into an array that already has the result shape
+inline void check_output_shape(const Shape& out, const Shape& expected) {
+    if (out != expected) {
+        throw std::runtime_error("Output shape " + shape_to_string(out) + " does not match result shape " + shape_to_string(expected));
+    }
+}
+
+// Same check for the broadcast of a and b, without building that shape unless
+// it has to report an error
+inline void check_output_shape(const Shape& out, const Shape& a, const Shape& b) {
+    bool fits = out.size() == std::max(a.size(), b.size());
+    for (size_t i = 0; fits && i < out.size(); ++i) {
+        size_t dim_a = i < a.size() ? a[a.size() - 1 - i] : 1;
+        size_t dim_b = i < b.size() ? b[b.size() - 1 - i] : 1;
+        size_t dim_out = out[out.size() - 1 - i];
+        fits = (dim_a == dim_out || dim_a == 1) && (dim_b == dim_out || dim_b == 1) &&
+               (dim_a == dim_out || dim_b == dim_out);
+    }
+    if (!fits) check_output_shape(out, broadcast_shapes(a, b));
+}
+
 } // namespace numbits
 
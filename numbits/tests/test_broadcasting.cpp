@@ -0,0 +1,103 @@
+#include <iostream>
+#include <cassert>
+#include "numbits/numbits.hpp"
+
+using namespace numbits;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+    std::cout << "Running " #name "... "; \
+    name(); \
+    std::cout << "OK\n";
+
+TEST_CASE(test_row_broadcast) {
+    ndarray<float> m({2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+    ndarray<float> row({1, 3}, {10.0f, 20.0f, 30.0f});
+    auto c = m + row;
+    assert(c.shape() == Shape({2, 3}));
+    assert(c[0] == 11.0f);
+    assert(c[2] == 33.0f);
+    assert(c[3] == 14.0f);
+    assert(c[5] == 36.0f);
+}
+
+TEST_CASE(test_column_broadcast) {
+    ndarray<float> m({2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+    ndarray<float> col({2, 1}, {1.0f, 2.0f});
+    auto c = col - m;
+    assert(c[0] == 0.0f);
+    assert(c[2] == -2.0f);
+    assert(c[3] == -2.0f);
+    assert(c[5] == -4.0f);
+}
+
+TEST_CASE(test_outer_broadcast) {
+    // (3, 1) * (4,) -> (3, 4)
+    ndarray<double> a({3, 1}, {1.0, 2.0, 3.0});
+    ndarray<double> b({1.0, 10.0, 100.0, 1000.0});
+    auto c = a * b;
+    assert(c.shape() == Shape({3, 4}));
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            assert(c.at({i, j}) == a[i] * b[j]);
+        }
+    }
+}
+
+TEST_CASE(test_middle_axis_broadcast) {
+    ndarray<int32_t> a({2, 1, 2}, {1, 2, 3, 4});
+    ndarray<int32_t> b({1, 3, 1}, {10, 20, 30});
+    auto c = add(a, b);
+    assert(c.shape() == Shape({2, 3, 2}));
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t k = 0; k < 2; ++k) {
+                assert(c.at({i, j, k}) == a.at({i, 0, k}) + b.at({0, j, 0}));
+            }
+        }
+    }
+}
+
+TEST_CASE(test_comparison_broadcast) {
+    ndarray<float> m({2, 2}, {1.0f, 5.0f, 3.0f, 2.0f});
+    ndarray<float> limit({2.5f});
+    auto c = less(m, limit);
+    assert(c[0] && !c[1] && !c[2] && c[3]);
+}
+
+TEST_CASE(test_broadcast_matches_broadcast_to) {
+    ndarray<float> a({4, 1}, {1.0f, 2.0f, 3.0f, 4.0f});
+    ndarray<float> b({1, 5}, {0.5f, 1.5f, 2.5f, 3.5f, 4.5f});
+    Shape shape = broadcast_shapes(a.shape(), b.shape());
+    auto expected_a = broadcast_to(a, shape);
+    auto expected_b = broadcast_to(b, shape);
+    auto c = divide(a, b);
+    for (size_t i = 0; i < c.size(); ++i) {
+        assert(c[i] == expected_a[i] / expected_b[i]);
+    }
+}
+
+TEST_CASE(test_incompatible_shapes) {
+    ndarray<float> a(Shape{2, 3});
+    ndarray<float> b(Shape{2, 2});
+    bool threw = false;
+    try {
+        auto c = a + b;
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+int main() {
+    RUN_TEST(test_row_broadcast);
+    RUN_TEST(test_column_broadcast);
+    RUN_TEST(test_outer_broadcast);
+    RUN_TEST(test_middle_axis_broadcast);
+    RUN_TEST(test_comparison_broadcast);
+    RUN_TEST(test_broadcast_matches_broadcast_to);
+    RUN_TEST(test_incompatible_shapes);
+
+    std::cout << "All tests passed!\n";
+    return 0;
+}
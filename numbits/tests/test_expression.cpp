@@ -0,0 +1,105 @@
+#include <iostream>
+#include <cassert>
+#include "numbits/numbits.hpp"
+
+using namespace numbits;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+    std::cout << "Running " #name "... "; \
+    name(); \
+    std::cout << "OK\n";
+
+TEST_CASE(test_fused_matches_eager) {
+    ndarray<float> a({2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+    ndarray<float> b({2, 3}, {0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f});
+    ndarray<float> c({2, 3}, {6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f});
+    ndarray<float> d({2, 3}, {1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f});
+    ndarray<float> fused = lazy(a) * b + lazy(c) * 2.0f - d;
+    ndarray<float> eager = a * b + c * 2.0f - d;
+    assert(fused.shape() == eager.shape());
+    for (size_t i = 0; i < fused.size(); ++i) {
+        assert(fused[i] == eager[i]);
+    }
+}
+
+TEST_CASE(test_fused_broadcast) {
+    ndarray<double> m({2, 3}, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+    ndarray<double> row({1, 3}, {10.0, 20.0, 30.0});
+    ndarray<double> col({2, 1}, {100.0, 200.0});
+    ndarray<double> r = (lazy(m) + row) * col / 2.0;
+    assert(r.shape() == Shape({2, 3}));
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            assert(r.at({i, j}) == (m.at({i, j}) + row[j]) * col[i] / 2.0);
+        }
+    }
+}
+
+TEST_CASE(test_scalar_on_left_and_negation) {
+    ndarray<float> a({1.0f, 2.0f, 4.0f});
+    ndarray<float> r = -(1.0f - lazy(a)) / a;
+    assert(r[0] == 0.0f);
+    assert(r[1] == 0.5f);
+    assert(r[2] == 0.75f);
+}
+
+TEST_CASE(test_temporary_operand_is_kept) {
+    ndarray<float> a({1.0f, 2.0f, 3.0f});
+    auto e = lazy(a) + a * 2.0f; // the eager product is moved into the expression
+    ndarray<float> r = e;
+    assert(r[0] == 3.0f);
+    assert(r[2] == 9.0f);
+}
+
+TEST_CASE(test_assign_reads_target) {
+    ndarray<float> a({1.0f, 2.0f, 3.0f});
+    a = lazy(a) * a + 1.0f;
+    assert(a[0] == 2.0f);
+    assert(a[1] == 5.0f);
+    assert(a[2] == 10.0f);
+}
+
+TEST_CASE(test_assign_reuses_buffer) {
+    ndarray<float> a({1.0f, 2.0f, 3.0f});
+    ndarray<float> row(Shape{1, 3});
+    ndarray<float> col(Shape{2, 1});
+    row.fill(1.0f);
+    col.fill(2.0f);
+    ndarray<float> r(Shape{2, 3});
+    const float* buffer = r.data();
+
+    r = lazy(row) * col + a;
+    assert(r.data() == buffer);
+    for (size_t i = 0; i < r.size(); ++i) assert(r[i] == 2.0f + a[i % 3]);
+    r = lazy(r) * 2.0f - a;
+    assert(r.data() == buffer);
+    for (size_t i = 0; i < r.size(); ++i) assert(r[i] == 4.0f + a[i % 3]);
+
+    // A new shape still gets a new buffer
+    r = lazy(a) + 1.0f;
+    assert(r.shape() == Shape({3}));
+    assert(r[2] == 4.0f);
+}
+
+TEST_CASE(test_expression_shape) {
+    ndarray<float> a(Shape{4, 1});
+    ndarray<float> b(Shape{3});
+    auto e = lazy(a) + b;
+    assert(e.shape() == Shape({4, 3}));
+    assert(e.size() == 12);
+    assert(e.ndim() == 2);
+}
+
+int main() {
+    RUN_TEST(test_fused_matches_eager);
+    RUN_TEST(test_fused_broadcast);
+    RUN_TEST(test_scalar_on_left_and_negation);
+    RUN_TEST(test_temporary_operand_is_kept);
+    RUN_TEST(test_assign_reads_target);
+    RUN_TEST(test_assign_reuses_buffer);
+    RUN_TEST(test_expression_shape);
+
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,160 @@
+// GCC misreports free() in the replaced operator delete as mismatched
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include "numbits/numbits.hpp"
+
+using namespace numbits;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+    std::cout << "Running " #name "... "; \
+    name(); \
+    std::cout << "OK\n";
+
+// Counts heap allocations so the tests can check that out= paths allocate nothing
+static size_t g_allocations = 0;
+
+void* operator new(size_t n) {
+    ++g_allocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+TEST_CASE(test_out_matches_returning) {
+    ndarray<double> a(Shape{2, 3});
+    ndarray<double> b(Shape{2, 3});
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = 0.5 + i;
+        b[i] = 2.0 - 0.25 * i;
+    }
+    ndarray<double> out(Shape{2, 3});
+
+    add(a, b, out);
+    for (size_t i = 0; i < out.size(); ++i) assert(out[i] == a[i] + b[i]);
+    divide(a, b, out);
+    for (size_t i = 0; i < out.size(); ++i) assert(out[i] == a[i] / b[i]);
+    multiply_scalar(a, 3.0, out);
+    for (size_t i = 0; i < out.size(); ++i) assert(out[i] == a[i] * 3.0);
+    sin(a, out);
+    ndarray<double> expected = sin(a);
+    for (size_t i = 0; i < out.size(); ++i) assert(out[i] == expected[i]);
+    pow(a, 2.0, out);
+    for (size_t i = 0; i < out.size(); ++i) assert(out[i] == std::pow(a[i], 2.0));
+    rsubtract_scalar(a, 1.0, out);
+    for (size_t i = 0; i < out.size(); ++i) assert(out[i] == 1.0 - a[i]);
+    rdivide_scalar(a, 1.0, out);
+    for (size_t i = 0; i < out.size(); ++i) assert(out[i] == 1.0 / a[i]);
+    negative(a, out);
+    for (size_t i = 0; i < out.size(); ++i) assert(out[i] == -a[i]);
+    ndarray<double> r = 1.0 - a;
+    for (size_t i = 0; i < r.size(); ++i) assert(r[i] == 1.0 - a[i]);
+    r = 2.0 / a;
+    for (size_t i = 0; i < r.size(); ++i) assert(r[i] == 2.0 / a[i]);
+    r = -a;
+    for (size_t i = 0; i < r.size(); ++i) assert(r[i] == -a[i]);
+
+    ndarray<bool> mask(Shape{2, 3});
+    less(a, b, mask);
+    for (size_t i = 0; i < mask.size(); ++i) assert(mask[i] == (a[i] < b[i]));
+}
+
+TEST_CASE(test_out_may_alias_input) {
+    ndarray<float> a(Shape{4});
+    for (size_t i = 0; i < a.size(); ++i) a[i] = static_cast<float>(i) + 1.0f;
+    ndarray<float> b = a;
+
+    sqrt(a, a);
+    for (size_t i = 0; i < a.size(); ++i) assert(a[i] == std::sqrt(b[i]));
+    negative(a, a);
+    for (size_t i = 0; i < a.size(); ++i) assert(a[i] == -std::sqrt(b[i]));
+    rsubtract_scalar(a, 0.0f, a);
+    for (size_t i = 0; i < a.size(); ++i) assert(a[i] == std::sqrt(b[i]));
+    subtract(b, a, b);
+    for (size_t i = 0; i < b.size(); ++i) assert(b[i] == (static_cast<float>(i) + 1.0f) - a[i]);
+}
+
+TEST_CASE(test_compound_assignment) {
+    ndarray<double> m(Shape{2, 3});
+    for (size_t i = 0; i < m.size(); ++i) m[i] = static_cast<double>(i);
+    ndarray<double> row(Shape{3});
+    row[0] = 10.0;
+    row[1] = 20.0;
+    row[2] = 30.0;
+
+    m += row;
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) assert(m.at({i, j}) == 3.0 * i + j + row[j]);
+    }
+    m *= 2.0;
+    m -= 1.0;
+    m /= row;
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) assert(m.at({i, j}) == ((3.0 * i + j + row[j]) * 2.0 - 1.0) / row[j]);
+    }
+}
+
+TEST_CASE(test_shape_mismatch_throws) {
+    ndarray<float> a(Shape{2, 3});
+    ndarray<float> col(Shape{2, 1});
+    ndarray<float> wrong(Shape{3, 2});
+    bool threw = false;
+    try { add(a, col, wrong); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+
+    // The result would broadcast to (2, 3), which does not fit in col
+    threw = false;
+    try { col += a; } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { exp(a, wrong); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+}
+
+TEST_CASE(test_update_loop_does_not_allocate) {
+    ndarray<float> x(Shape{64, 32});
+    ndarray<float> v(Shape{64, 32});
+    ndarray<float> grad(Shape{64, 32});
+    ndarray<float> bias(Shape{32});
+    ndarray<float> prev(Shape{64, 32});
+    for (size_t i = 0; i < x.size(); ++i) x[i] = 0.01f * static_cast<float>(i % 97);
+    for (size_t i = 0; i < bias.size(); ++i) bias[i] = 0.001f * static_cast<float>(i);
+    v.fill(0.0f);
+
+    const size_t before = g_allocations;
+    for (int step = 0; step < 10; ++step) {
+        prev = x;
+        tanh(x, grad);
+        grad += bias;
+        v *= 0.9f;
+        v = lazy(v) + lazy(grad) * 0.1f;
+        x -= v;
+    }
+    assert(g_allocations == before);
+}
+
+int main() {
+    std::cout << "Running in-place operation tests...\n";
+
+    RUN_TEST(test_out_matches_returning);
+    RUN_TEST(test_out_may_alias_input);
+    RUN_TEST(test_compound_assignment);
+    RUN_TEST(test_shape_mismatch_throws);
+    RUN_TEST(test_update_loop_does_not_allocate);
+
+    std::cout << "All in-place operation tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <cassert>
+#include "numbits/numbits.hpp"
+
+using namespace numbits;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+    std::cout << "Running " #name "... "; \
+    name(); \
+    std::cout << "OK\n";
+
+static ndarray<int32_t> iota(const Shape& shape) {
+    ndarray<int32_t> arr(shape);
+    for (size_t i = 0; i < arr.size(); ++i) arr[i] = static_cast<int32_t>(i);
+    return arr;
+}
+
+TEST_CASE(test_contiguous_dimensions_collapse) {
+    Shape shape{2, 3, 4};
+    Strides contiguous = compute_strides(shape);
+    NdIterator<2> it(shape, {contiguous, contiguous});
+    assert(it.ndim() == 1);
+    size_t runs = 0, count = 0;
+    it.for_each_run([&](const NdIterator<2>::Offsets& off, size_t n, const NdIterator<2>::Offsets& step) {
+        assert(off[0] == 0 && off[1] == 0);
+        assert(step[0] == 1 && step[1] == 1);
+        count += n;
+        ++runs;
+    });
+    assert(runs == 1);
+    assert(count == 24);
+}
+
+TEST_CASE(test_broadcast_dimensions_stay_separate) {
+    // (4, 1) read as (4, 5): the row does not advance along the last axis
+    ndarray<int32_t> col = iota({4, 1});
+    Shape shape{4, 5};
+    NdIterator<2> it(shape, {compute_strides(shape), broadcast_strides(col, shape)});
+    assert(it.ndim() == 2);
+    size_t runs = 0;
+    it.for_each_run([&](const NdIterator<2>::Offsets& off, size_t n, const NdIterator<2>::Offsets& step) {
+        assert(n == 5);
+        assert(step[1] == 0);
+        assert(off[0] == runs * 5 && off[1] == runs);
+        ++runs;
+    });
+    assert(runs == 4);
+}
+
+TEST_CASE(test_broadcast_iterator) {
+    ndarray<int32_t> row = iota({1, 3});
+    BroadcastIterator<int32_t> it(row, {2, 3});
+    for (size_t i = 0; i < 6; ++i) {
+        assert(!it.is_end());
+        assert(it.get_value() == static_cast<int32_t>(i % 3));
+        it.increment();
+    }
+    assert(it.is_end());
+}
+
+TEST_CASE(test_take_axis1) {
+    ndarray<int32_t> arr = iota({3, 4});
+    auto t = take(arr, {3, 0, 3}, 1);
+    assert(t.shape() == Shape({3, 3}));
+    for (size_t i = 0; i < 3; ++i) {
+        assert(t.at({i, 0}) == arr.at({i, 3}));
+        assert(t.at({i, 1}) == arr.at({i, 0}));
+        assert(t.at({i, 2}) == arr.at({i, 3}));
+    }
+}
+
+TEST_CASE(test_where_broadcast_condition) {
+    ndarray<bool> cond({1, 3}, {true, false, true});
+    ndarray<int32_t> x = iota({2, 3});
+    ndarray<int32_t> y = ndarray<int32_t>::full({2, 3}, -1);
+    auto w = where(cond, x, y);
+    assert(w.shape() == Shape({2, 3}));
+    for (size_t i = 0; i < 6; ++i) {
+        assert(w[i] == (i % 3 != 1 ? x[i] : -1));
+    }
+}
+
+TEST_CASE(test_tile) {
+    ndarray<int32_t> arr = iota({2, 3});
+    auto t = tile(arr, {2, 3});
+    assert(t.shape() == Shape({4, 9}));
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 9; ++j) {
+            assert(t.at({i, j}) == arr.at({i % 2, j % 3}));
+        }
+    }
+}
+
+TEST_CASE(test_concatenate_axis1) {
+    ndarray<int32_t> a = iota({2, 2});
+    ndarray<int32_t> b = iota({2, 3});
+    auto c = concatenate(std::vector<ndarray<int32_t>>{a, b}, 1);
+    assert(c.shape() == Shape({2, 5}));
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            assert(c.at({i, j}) == (j < 2 ? a.at({i, j}) : b.at({i, j - 2})));
+        }
+    }
+}
+
+TEST_CASE(test_empty_shape) {
+    ndarray<int32_t> a(Shape{0, 3});
+    auto t = tile(a, {2, 2});
+    assert(t.size() == 0);
+}
+
+int main() {
+    RUN_TEST(test_contiguous_dimensions_collapse);
+    RUN_TEST(test_broadcast_dimensions_stay_separate);
+    RUN_TEST(test_broadcast_iterator);
+    RUN_TEST(test_take_axis1);
+    RUN_TEST(test_where_broadcast_condition);
+    RUN_TEST(test_tile);
+    RUN_TEST(test_concatenate_axis1);
+    RUN_TEST(test_empty_shape);
+
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -1,9 +1,17 @@
 #include "catplot/axes.hpp"
 #include "svg_backend.hpp"
+#include "raster_canvas.hpp"
+#include "display_list.hpp"
+#include "counting_canvas.hpp"
+#include "simd_minmax.hpp"
+#include "simd_affine.hpp"
+#include "ring_series.hpp"
+#include "render_arena.hpp"
 #include <algorithm>
 #include <stdexcept>
 #include <cmath>
-#include <tuple>
+#include <limits>
+#include <memory_resource>
 
 namespace catplot {
 
@@ -16,21 +24,160 @@ Rgba Rgba::Blue() { return {0,0,1,1}; }
 Axes::Axes(int figureWidthPx, int figureHeightPx)
 	: widthPx(figureWidthPx), heightPx(figureHeightPx) {}
 
-void Axes::plot(const std::vector<double>& x, const std::vector<double>& y, const Rgba& color, double lineWidthPx, const std::string& label) {
+SeriesHandle Axes::plot(const std::vector<double>& x, const std::vector<double>& y, const Rgba& color, double lineWidthPx, const std::string& label, const LineDecimation& decimation) {
 	if (x.size() != y.size()) throw std::invalid_argument("x and y must be same length");
-	lines.push_back(LineSeries{ x, y, color, lineWidthPx, label });
+	return plot(SeriesData::own(std::vector<double>(x)), SeriesData::own(std::vector<double>(y)), color, lineWidthPx, label, decimation);
 }
 
-void Axes::scatter(const std::vector<double>& x, const std::vector<double>& y, double radiusPx, const Rgba& color, const std::string& label) {
+SeriesHandle Axes::plot(SeriesData x, SeriesData y, const Rgba& color, double lineWidthPx, const std::string& label, const LineDecimation& decimation) {
 	if (x.size() != y.size()) throw std::invalid_argument("x and y must be same length");
-	scatters.push_back(ScatterSeries{ x, y, radiusPx, color, label });
+	LineSeries s;
+	s.x = std::move(x);
+	s.y = std::move(y);
+	s.color = color;
+	s.widthPx = lineWidthPx;
+	s.label = label;
+	s.decimation = decimation;
+	lines.push_back(std::move(s));
+	boundsValid = false;
+	++version;
+	return SeriesHandle(this, false, lines.size() - 1);
 }
 
-void Axes::set_title(const std::string& titleText) { title = titleText; }
-void Axes::set_xlabel(const std::string& labelText) { xlabel = labelText; }
-void Axes::set_ylabel(const std::string& labelText) { ylabel = labelText; }
-void Axes::grid(bool enabled) { showGrid = enabled; }
-void Axes::legend(bool enabled) { showLegend = enabled; }
+SeriesHandle Axes::scatter(const std::vector<double>& x, const std::vector<double>& y, double radiusPx, const Rgba& color, const std::string& label, const ScatterMode& mode) {
+	if (x.size() != y.size()) throw std::invalid_argument("x and y must be same length");
+	return scatter(SeriesData::own(std::vector<double>(x)), SeriesData::own(std::vector<double>(y)), radiusPx, color, label, mode);
+}
+
+SeriesHandle Axes::scatter(SeriesData x, SeriesData y, double radiusPx, const Rgba& color, const std::string& label, const ScatterMode& mode) {
+	if (x.size() != y.size()) throw std::invalid_argument("x and y must be same length");
+	ScatterSeries s;
+	s.x = std::move(x);
+	s.y = std::move(y);
+	s.radiusPx = radiusPx;
+	s.color = color;
+	s.label = label;
+	s.mode = mode;
+	scatters.push_back(std::move(s));
+	boundsValid = false;
+	++version;
+	return SeriesHandle(this, true, scatters.size() - 1);
+}
+
+SeriesHandle Axes::plot_ring(size_t capacity, const Rgba& color, double lineWidthPx, const std::string& label, const LineDecimation& decimation) {
+	LineSeries s;
+	s.color = color;
+	s.widthPx = lineWidthPx;
+	s.label = label;
+	s.decimation = decimation;
+	s.ring = std::make_shared<RingSeries>(capacity);
+	lines.push_back(std::move(s));
+	boundsValid = false;
+	++version;
+	return SeriesHandle(this, false, lines.size() - 1);
+}
+
+// NaN breaks the order, so such series are scanned in full
+static bool ascending(const double* x, size_t n) {
+	for (size_t i = 1; i < n; ++i) {
+		if (!(x[i] >= x[i - 1])) return false;
+	}
+	return n == 0 || x[0] == x[0];
+}
+
+void Axes::append_samples(bool scatterSeries, size_t index, const double* x, const double* y, size_t n) {
+	if (n == 0) return;
+	++version;
+	if (!scatterSeries && lines[index].ring) {
+		// Samples drop out of a ring, so cached bounds cannot be merged
+		lines[index].ring->push(x, y, n);
+		boundsValid = false;
+		return;
+	}
+	SeriesData& sx = scatterSeries ? scatters[index].x : lines[index].x;
+	SeriesData& sy = scatterSeries ? scatters[index].y : lines[index].y;
+	if (!scatterSeries && lines[index].xSorted) {
+		lines[index].xSorted = ascending(x, n) && (sx.empty() || x[0] >= sx[sx.size() - 1]);
+	}
+	sx.append(x, n);
+	sy.append(y, n);
+	// Cached bounds only need the new samples merged in
+	if (boundsValid) {
+		double xmn, xmx, ymn, ymx;
+		if (!minmax_f64(x, n, xmn, xmx) || !minmax_f64(y, n, ymn, ymx)) {
+			boundsValid = false; // all-NaN block: rescan on next use
+		} else if (boundsCache.empty) {
+			boundsCache = DataBounds{xmn, xmx, ymn, ymx, false};
+		} else {
+			boundsCache.xmin = std::min(boundsCache.xmin, xmn); boundsCache.xmax = std::max(boundsCache.xmax, xmx);
+			boundsCache.ymin = std::min(boundsCache.ymin, ymn); boundsCache.ymax = std::max(boundsCache.ymax, ymx);
+		}
+	}
+}
+
+void SeriesHandle::append(double x, double y) {
+	append(&x, &y, 1);
+}
+
+void SeriesHandle::append(const double* x, const double* y, size_t n) {
+	if (!axes) throw std::logic_error("append on an empty SeriesHandle");
+	axes->append_samples(isScatter, index, x, y, n);
+}
+
+void SeriesHandle::append(const std::vector<double>& x, const std::vector<double>& y) {
+	if (x.size() != y.size()) throw std::invalid_argument("x and y must be same length");
+	append(x.data(), y.data(), x.size());
+}
+
+size_t SeriesHandle::size() const {
+	if (!axes) return 0;
+	if (isScatter) return axes->scatters[index].x.size();
+	const auto& line = axes->lines[index];
+	return line.ring ? line.ring->size() : line.x.size();
+}
+
+void Axes::validate_arrays(size_t xdim, size_t ydim, size_t xsize, size_t ysize, const char* what) {
+	if (xdim != 1) {
+		throw std::invalid_argument("NumBits array 'x' must be 1D for " + std::string(what) + ", got " + std::to_string(xdim) + " dimensions");
+	}
+	if (ydim != 1) {
+		throw std::invalid_argument("NumBits array 'y' must be 1D for " + std::string(what) + ", got " + std::to_string(ydim) + " dimensions");
+	}
+	if (xsize != ysize) {
+		throw std::invalid_argument("X and Y arrays must have the same size: X has " + std::to_string(xsize) + " elements, Y has " + std::to_string(ysize) + " elements");
+	}
+	if (xsize == 0) {
+		throw std::invalid_argument("Cannot plot empty arrays");
+	}
+}
+
+void Axes::set_title(const std::string& titleText) { title = titleText; ++version; }
+void Axes::set_xlabel(const std::string& labelText) { xlabel = labelText; ++version; }
+void Axes::set_ylabel(const std::string& labelText) { ylabel = labelText; ++version; }
+void Axes::grid(bool enabled) { showGrid = enabled; ++version; }
+void Axes::legend(bool enabled) { showLegend = enabled; ++version; }
+
+void Axes::mark_changed() {
+	++version;
+	boundsValid = false;
+	for (auto& s : lines) s.sortKnown = false;
+}
+
+void Axes::set_xlim(double lo, double hi) {
+	if (!(lo < hi) || !std::isfinite(lo) || !std::isfinite(hi)) throw std::invalid_argument("x limits must be finite with lo < hi");
+	xlimLo = lo;
+	xlimHi = hi;
+	xlimSet = true;
+	++version;
+}
+
+void Axes::set_ylim(double lo, double hi) {
+	if (!(lo < hi) || !std::isfinite(lo) || !std::isfinite(hi)) throw std::invalid_argument("y limits must be finite with lo < hi");
+	ylimLo = lo;
+	ylimHi = hi;
+	ylimSet = true;
+	++version;
+}
 
 std::pair<double, double> Axes::minmax(const std::vector<double>& v) {
 	if (v.empty()) return {0.0, 1.0};
@@ -45,67 +192,240 @@ void Axes::expand_range(double& vmin, double& vmax, double expandFrac) {
 	vmin -= pad; vmax += pad;
 }
 
-std::string Axes::render_svg() const {
-	std::vector<std::pair<std::vector<double>, std::vector<double>>> lineXY;
-	std::vector<Rgba> lineColors;
-	std::vector<double> lineWidths;
-	lineXY.reserve(lines.size());
-	lineColors.reserve(lines.size());
-	lineWidths.reserve(lines.size());
+// Min/max of one series array; contiguous doubles go through the SIMD kernel
+static bool series_minmax(const SeriesData& d, double& mn, double& mx) {
+	if (d.type() == ElementType::Float64 && d.stride() == 1) {
+		return minmax_f64(static_cast<const double*>(d.data()), d.size(), mn, mx);
+	}
+	return d.visit([&](const auto* base, std::ptrdiff_t stride, std::size_t n) {
+		double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+		for (std::size_t i = 0; i < n; ++i) {
+			double v = static_cast<double>(base[static_cast<std::ptrdiff_t>(i) * stride]);
+			if (v < lo) lo = v;
+			if (v > hi) hi = v;
+		}
+		if (!(lo <= hi)) return false;
+		mn = lo;
+		mx = hi;
+		return true;
+	});
+}
+
+DataBounds Axes::data_bounds() const {
+	if (boundsValid) return boundsCache;
+	DataBounds b;
+	auto consider = [&b](const SeriesData& x, const SeriesData& y) {
+		double xmn, xmx, ymn, ymx;
+		if (!series_minmax(x, xmn, xmx) || !series_minmax(y, ymn, ymx)) return;
+		if (b.empty) {
+			b = DataBounds{xmn, xmx, ymn, ymx, false};
+			return;
+		}
+		b.xmin = std::min(b.xmin, xmn); b.xmax = std::max(b.xmax, xmx);
+		b.ymin = std::min(b.ymin, ymn); b.ymax = std::max(b.ymax, ymx);
+	};
+	// Ring buffers: contiguous double segments
+	auto considerSpan = [&b](const SeriesSpan& span) {
+		span.for_each_segment([&b](const SampleColumn& xs, const SampleColumn& ys, size_t n, size_t) {
+			double xmn, xmx, ymn, ymx;
+			if (!minmax_f64(xs.contiguous_f64(), n, xmn, xmx) || !minmax_f64(ys.contiguous_f64(), n, ymn, ymx)) return;
+			if (b.empty) {
+				b = DataBounds{xmn, xmx, ymn, ymx, false};
+				return;
+			}
+			b.xmin = std::min(b.xmin, xmn); b.xmax = std::max(b.xmax, xmx);
+			b.ymin = std::min(b.ymin, ymn); b.ymax = std::max(b.ymax, ymx);
+		});
+	};
 	for (const auto& s : lines) {
-		lineXY.emplace_back(s.x, s.y);
-		lineColors.push_back(s.color);
-		lineWidths.push_back(s.widthPx);
+		if (s.ring) considerSpan(s.ring->spans());
+		else consider(s.x, s.y);
 	}
+	for (const auto& s : scatters) consider(s.x, s.y);
+	boundsCache = b;
+	boundsValid = true;
+	return b;
+}
+
+// Axis limits: set_xlim()/set_ylim() where given, otherwise the data extent
+// padded by 5% (0..1 without data)
+DataBounds Axes::view_bounds() const {
+	DataBounds b = data_bounds();
+	if (b.empty) b = DataBounds{0, 1, 0, 1, false};
+	expand_range(b.xmin, b.xmax, 0.05);
+	expand_range(b.ymin, b.ymax, 0.05);
+	if (xlimSet) { b.xmin = xlimLo; b.xmax = xlimHi; }
+	if (ylimSet) { b.ymin = ylimLo; b.ymax = ylimHi; }
+	return b;
+}
+
+// Fragment caching is limited to series backed by their own buffer: borrowed
+// data may change behind the series without the cache noticing
+template<typename Series>
+static SeriesFragmentCache* fragment_cache(const Series& s) {
+	return s.x.owns_buffer() && s.y.owns_buffer() ? &s.svgCache : nullptr;
+}
+
+// ascending() over a column of any element type and stride
+static bool ascending(const SampleColumn& c, size_t n) {
+	if (const double* p = c.contiguous_f64()) return ascending(p, n);
+	return c.visit([&c, n](const auto* base) {
+		double prev = 0.0;
+		for (size_t i = 0; i < n; ++i) {
+			double v = static_cast<double>(base[static_cast<std::ptrdiff_t>(i) * c.stride]);
+			if (i > 0 ? !(v >= prev) : v != v) return false;
+			prev = v;
+		}
+		return true;
+	});
+}
+
+// First index in [lo, hi) for which below(k) is false (below must be monotone)
+template<typename Pred>
+static size_t partition_index(size_t lo, size_t hi, Pred below) {
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (below(mid)) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// Samples of an ascending-x line that can reach [xmin, xmax]: the binary-searched
+// visible range plus one neighbour on each side for the segments crossing it
+static SeriesSpan visible_range(const SeriesSpan& span, double xmin, double xmax) {
+	const SampleColumn& xs = span.x[0];
+	const size_t n = span.n[0];
+	size_t lo = partition_index(0, n, [&xs, xmin](size_t k) { return xs.at(k) < xmin; });
+	size_t hi = partition_index(lo, n, [&xs, xmax](size_t k) { return xs.at(k) <= xmax; });
+	lo = lo > 0 ? lo - 1 : 0;
+	hi = std::min(hi + 1, n);
+	return SeriesSpan::of(xs.offset_by(lo), span.y[0].offset_by(lo), hi - lo);
+}
+
+// Line samples handed to the renderer, viewing the series storage in place; with
+// x limits an ascending line is narrowed to its visible range
+template<typename Line>
+static SeriesSpan render_span(const Line& s, const DataBounds& view, bool narrowX) {
+	if (s.ring) return s.ring->spans();
+	SeriesSpan span = SeriesSpan::of(s.x, s.y);
+	if (!narrowX) return span;
+	if (!s.sortKnown) {
+		s.xSorted = ascending(span.x[0], span.n[0]);
+		s.sortKnown = true;
+	}
+	return s.xSorted ? visible_range(span, view.xmin, view.xmax) : span;
+}
+
+// Per-series inputs of SvgBackend for one render, allocated from the render arena
+struct Axes::StagedSeries {
+	explicit StagedSeries(std::pmr::memory_resource* arena)
+		: lineXY(arena), lineColors(arena), lineWidths(arena), lineDecimation(arena), lineCache(arena),
+		  scatterXY(arena), scatterColors(arena), scatterRadius(arena), scatterMode(arena), scatterCache(arena) {}
+
+	std::pmr::vector<SeriesSpan> lineXY;
+	std::pmr::vector<Rgba> lineColors;
+	std::pmr::vector<double> lineWidths;
+	std::pmr::vector<LineDecimation> lineDecimation;
+	std::pmr::vector<SeriesFragmentCache*> lineCache;
+	std::pmr::vector<SeriesSpan> scatterXY;
+	std::pmr::vector<Rgba> scatterColors;
+	std::pmr::vector<double> scatterRadius;
+	std::pmr::vector<ScatterMode> scatterMode;
+	std::pmr::vector<SeriesFragmentCache*> scatterCache;
+};
 
-	std::vector<std::pair<std::vector<double>, std::vector<double>>> scatterXY;
-	std::vector<Rgba> scatterColors;
-	std::vector<double> scatterRadius;
-	scatterXY.reserve(scatters.size());
-	scatterColors.reserve(scatters.size());
-	scatterRadius.reserve(scatters.size());
+void Axes::stage_series(StagedSeries& out, const DataBounds& view) const {
+	out.lineXY.reserve(lines.size());
+	out.lineColors.reserve(lines.size());
+	out.lineWidths.reserve(lines.size());
+	out.lineDecimation.reserve(lines.size());
+	out.lineCache.reserve(lines.size());
+	for (const auto& s : lines) {
+		out.lineXY.push_back(render_span(s, view, xlimSet));
+		out.lineColors.push_back(s.color);
+		out.lineWidths.push_back(s.widthPx);
+		out.lineDecimation.push_back(s.decimation);
+		out.lineCache.push_back(fragment_cache(s));
+	}
+	out.scatterXY.reserve(scatters.size());
+	out.scatterColors.reserve(scatters.size());
+	out.scatterRadius.reserve(scatters.size());
+	out.scatterMode.reserve(scatters.size());
+	out.scatterCache.reserve(scatters.size());
 	for (const auto& s : scatters) {
-		scatterXY.emplace_back(s.x, s.y);
-		scatterColors.push_back(s.color);
-		scatterRadius.push_back(s.radiusPx);
+		out.scatterXY.push_back(SeriesSpan::of(s.x, s.y));
+		out.scatterColors.push_back(s.color);
+		out.scatterRadius.push_back(s.radiusPx);
+		out.scatterMode.push_back(s.mode);
+		out.scatterCache.push_back(fragment_cache(s));
+	}
+}
+
+ArenaStats Axes::last_render_arena() const { return lastArena; }
+
+RenderCacheStats Axes::render_cache_stats() const { return cacheStats; }
+
+// Viewports kept per Axes; the oldest is dropped beyond this
+constexpr size_t kRenderCacheEntries = 4;
+
+const std::string& Axes::cached_svg_fragment(double x, double y, double w, double h, int precision) const {
+	const std::array<double, 5> key{x, y, w, h, static_cast<double>(precision)};
+	renderCache.erase(std::remove_if(renderCache.begin(), renderCache.end(),
+		[this](const RenderedFragment& f) { return f.version != version; }), renderCache.end());
+	for (const auto& f : renderCache) {
+		if (f.key == key) {
+			++cacheStats.hits;
+			return f.svg;
+		}
 	}
+	++cacheStats.misses;
+	std::string svg;
+	SvgCanvas part(SvgCanvas::Fragment{}, [&svg](const char* data, size_t n) { svg.append(data, n); });
+	part.set_precision(precision);
+	render_to(part, x, y, w, h);
+	part.finish();
+	if (renderCache.size() >= kRenderCacheEntries) renderCache.erase(renderCache.begin());
+	renderCache.push_back(RenderedFragment{version, key, std::move(svg)});
+	return renderCache.back().svg;
+}
 
-	return SvgBackend::render(
+std::string Axes::render_svg() const {
+	RenderArena arena;
+	const DataBounds view = view_bounds();
+	StagedSeries staged(&arena);
+	stage_series(staged, view);
+	std::string svg = SvgBackend::render(
 		widthPx, heightPx,
 		marginLeft, marginRight, marginTop, marginBottom,
-		lineXY, lineColors, lineWidths,
-		scatterXY, scatterColors, scatterRadius,
-		title, xlabel, ylabel
+		staged.lineXY, staged.lineColors, staged.lineWidths, staged.lineDecimation,
+		staged.scatterXY, staged.scatterColors, staged.scatterRadius, staged.scatterMode,
+		view, xlimSet || ylimSet, staged.lineCache, staged.scatterCache,
+		title, xlabel, ylabel, &arena
 	);
+	lastArena = arena.stats();
+	return svg;
 }
 
-void Axes::render_to(SvgCanvas& canvas, double x, double y, double w, double h) const {
+template<typename CanvasT>
+void Axes::render_to(CanvasT& canvas, double x, double y, double w, double h) const {
+	RenderArena arena;
 	// Use a translated group for this axes viewport
 	canvas.begin_group_translate(x, y);
-	std::vector<std::pair<std::vector<double>, std::vector<double>>> lineXY;
-	std::vector<Rgba> lineColors;
-	std::vector<double> lineWidths;
-	for (const auto& s : lines) {
-		lineXY.emplace_back(s.x, s.y);
-		lineColors.push_back(s.color);
-		lineWidths.push_back(s.widthPx);
+	const DataBounds view = view_bounds();
+	{
+		StagedSeries staged(&arena);
+		stage_series(staged, view);
+		SvgBackend::render_into(
+			canvas,
+			static_cast<int>(w), static_cast<int>(h),
+			marginLeft, marginRight, marginTop, marginBottom,
+			staged.lineXY, staged.lineColors, staged.lineWidths, staged.lineDecimation,
+			staged.scatterXY, staged.scatterColors, staged.scatterRadius, staged.scatterMode,
+			view, xlimSet || ylimSet, staged.lineCache, staged.scatterCache,
+			title, xlabel, ylabel, &arena
+		);
 	}
-	std::vector<std::pair<std::vector<double>, std::vector<double>>> scatterXY;
-	std::vector<Rgba> scatterColors;
-	std::vector<double> scatterRadius;
-	for (const auto& s : scatters) {
-		scatterXY.emplace_back(s.x, s.y);
-		scatterColors.push_back(s.color);
-		scatterRadius.push_back(s.radiusPx);
-	}
-	SvgBackend::render_into(
-		canvas,
-		static_cast<int>(w), static_cast<int>(h),
-		marginLeft, marginRight, marginTop, marginBottom,
-		lineXY, lineColors, lineWidths,
-		scatterXY, scatterColors, scatterRadius,
-		title, xlabel, ylabel
-	);
 	// Legend (simple, top-right inside plot area)
 	if (showLegend) {
 		const double plotLeft = marginLeft;
@@ -115,7 +435,7 @@ void Axes::render_to(SvgCanvas& canvas, double x, double y, double w, double h)
 		double ly = plotTop + 10.0;
 		double entryH = 18.0;
 		double boxW = 130.0;
-		std::vector<std::pair<std::string, Rgba>> entries;
+		std::pmr::vector<std::pair<std::string, Rgba>> entries(&arena);
 		for (const auto& s : lines) if (!s.label.empty()) entries.push_back({s.label, s.color});
 		for (const auto& s : scatters) if (!s.label.empty()) entries.push_back({s.label, s.color});
 		if (!entries.empty()) {
@@ -133,27 +453,11 @@ void Axes::render_to(SvgCanvas& canvas, double x, double y, double w, double h)
 	}
 	// Grid: overlay after ticks. Simple vertical and horizontal lines at tick positions
 	if (showGrid) {
-		// Recompute bounds and ticks like SvgBackend does
-		std::vector<std::pair<std::vector<double>, std::vector<double>>> lineXYLocal;
-		for (const auto& s : lines) lineXYLocal.emplace_back(s.x, s.y);
-		std::vector<std::pair<std::vector<double>, std::vector<double>>> scatterXYLocal;
-		for (const auto& s : scatters) scatterXYLocal.emplace_back(s.x, s.y);
-		auto bounds = [&]() {
-			bool has=false; double xmin=0,xmax=0,ymin=0,ymax=0;
-			auto consider=[&](const std::vector<double>& xs,const std::vector<double>& ys){
-				for(size_t i=0;i<xs.size()&&i<ys.size();++i){double X=xs[i],Y=ys[i]; if(!has){xmin=xmax=X;ymin=ymax=Y;has=true;} xmin=std::min(xmin,X);xmax=std::max(xmax,X);ymin=std::min(ymin,Y);ymax=std::max(ymax,Y);} };
-			for (const auto& p : lineXYLocal) consider(p.first,p.second);
-			for (const auto& p : scatterXYLocal) consider(p.first,p.second);
-			if (!has){xmin=0;xmax=1;ymin=0;ymax=1;}
-			double padX=(xmax-xmin); if (padX==0) { xmin-=0.5; xmax+=0.5; } else { double p=padX*0.05; xmin-=p; xmax+=p; }
-			double padY=(ymax-ymin); if (padY==0) { ymin-=0.5; ymax+=0.5; } else { double p=padY*0.05; ymin-=p; ymax+=p; }
-			return std::tuple<double,double,double,double>{xmin,xmax,ymin,ymax};
-		}();
-		double xmin, xmax, ymin, ymax;
-		std::tie(xmin, xmax, ymin, ymax) = bounds;
+		// Same limits as SvgBackend
+		const double xmin = view.xmin, xmax = view.xmax, ymin = view.ymin, ymax = view.ymax;
 		auto xticks = [&](){
 			// reuse simple nice ticks logic
-			std::vector<double> ticks;
+			std::pmr::vector<double> ticks(&arena);
 			double range = xmax - xmin; if (range<=0) range = 1.0;
 			double rawStep = range / 6.0;
 			double mag = std::pow(10.0, std::floor(std::log10(rawStep)));
@@ -164,7 +468,7 @@ void Axes::render_to(SvgCanvas& canvas, double x, double y, double w, double h)
 			return ticks;
 		}();
 		auto yticks = [&](){
-			std::vector<double> ticks;
+			std::pmr::vector<double> ticks(&arena);
 			double range = ymax - ymin; if (range<=0) range = 1.0;
 			double rawStep = range / 6.0;
 			double mag = std::pow(10.0, std::floor(std::log10(rawStep)));
@@ -174,31 +478,26 @@ void Axes::render_to(SvgCanvas& canvas, double x, double y, double w, double h)
 			for (double v=start; v<=ymax+1e-12; v+=step) ticks.push_back(v);
 			return ticks;
 		}();
-		auto mapx = [&](double xv) {
-			double t = (xv - xmin) / (xmax - xmin);
-			double left = marginLeft;
-			double right = w - marginRight;
-			return left + t * (right - left);
-		};
-		auto mapy = [&](double yv) {
-			double t = (yv - ymin) / (ymax - ymin);
-			double top = marginTop;
-			double bottom = h - marginBottom;
-			return bottom - t * (bottom - top);
-		};
+		// Same pixel mapping as the backend, in one batch per axis
+		const AxisAffine mx = axis_affine(xmin, xmax, marginLeft, w - marginRight);
+		const AxisAffine my = axis_affine(ymin, ymax, h - marginBottom, marginTop);
+		affine_f64(xticks.data(), xticks.size(), mx, xticks.data());
+		affine_f64(yticks.data(), yticks.size(), my, yticks.data());
 		std::string gridColor = "rgba(0,0,0,0.1)";
-		for (double xv : xticks) {
-			double X = mapx(xv);
+		for (double X : xticks) {
 			canvas.line(X, marginTop, X, h - marginBottom, gridColor, 1.0, "butt");
 		}
-		for (double yv : yticks) {
-			double Y = mapy(yv);
+		for (double Y : yticks) {
 			canvas.line(marginLeft, Y, w - marginRight, Y, gridColor, 1.0, "butt");
 		}
 	}
 	canvas.end_group();
+	lastArena = arena.stats();
 }
 
-} // namespace catplot
-
+#define CATPLOT_INSTANTIATE_RENDER_TO(CanvasT) \
+	template void Axes::render_to<CanvasT>(CanvasT& canvas, double x, double y, double w, double h) const;
+CATPLOT_FOR_EACH_CANVAS(CATPLOT_INSTANTIATE_RENDER_TO)
+#undef CATPLOT_INSTANTIATE_RENDER_TO
 
+} // namespace catplot
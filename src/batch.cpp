@@ -0,0 +1,102 @@
+#include "catplot/batch.hpp"
+#include "catplot/figure.hpp"
+#include "svg_canvas.hpp"
+#include "render_arena.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <memory_resource>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace catplot {
+
+// Counting semaphore bounding the files open at once; writers wait for a slot
+class BatchRenderer::FileSlots {
+public:
+	explicit FileSlots(std::size_t n) : available(n) {}
+
+	void acquire() {
+		std::unique_lock<std::mutex> lock(mutex);
+		freed.wait(lock, [this] { return available > 0; });
+		--available;
+	}
+	void release() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			++available;
+		}
+		freed.notify_one();
+	}
+
+private:
+	std::mutex mutex;
+	std::condition_variable freed;
+	std::size_t available;
+};
+
+namespace {
+
+// Documents above this size are not kept around for the next figure
+constexpr std::size_t kMaxRetainedDocument = 16u << 20;
+
+// Buffers a worker thread reuses across figures and batches
+struct WorkerScratch {
+	std::string document;
+	// Arena blocks go back here instead of to the heap after each render
+	std::pmr::unsynchronized_pool_resource arenaHeap{std::pmr::pool_options{0, 4u << 20}};
+};
+
+WorkerScratch& worker_scratch() {
+	thread_local WorkerScratch scratch;
+	return scratch;
+}
+
+} // namespace
+
+BatchRenderer::BatchRenderer(int threads, std::size_t maxOpenFiles) {
+	if (threads < 0) throw std::out_of_range("Batch thread count must be non-negative");
+	unsigned n = threads > 0 ? static_cast<unsigned>(threads) : std::max(1u, std::thread::hardware_concurrency());
+	// The thread calling save_all() takes part, so n threads need n - 1 workers
+	pool = std::make_unique<ThreadPool>(n - 1);
+	maxOpen = maxOpenFiles > 0 ? maxOpenFiles : n;
+	slots = std::make_unique<FileSlots>(maxOpen);
+}
+
+BatchRenderer::~BatchRenderer() = default;
+
+int BatchRenderer::threads() const { return static_cast<int>(pool->size()) + 1; }
+
+void BatchRenderer::save_all(const std::vector<BatchJob>& jobs) {
+	for (const auto& job : jobs) {
+		if (!job.figure) throw std::invalid_argument("Batch job without a figure: " + job.path);
+	}
+	pool->parallel_for(jobs.size(), [this, &jobs](std::size_t i) {
+		const BatchJob& job = jobs[i];
+		WorkerScratch& scratch = worker_scratch();
+		// Render into memory first so a file is only open while it is written
+		std::string& doc = scratch.document;
+		doc.clear();
+		{
+			ScopedArenaHeap heap(&scratch.arenaHeap);
+			SvgCanvas canvas(job.figure->width(), job.figure->height(), [&doc](const char* data, std::size_t n) { doc.append(data, n); });
+			job.figure->write_svg(canvas, nullptr);
+		}
+
+		slots->acquire();
+		struct SlotGuard {
+			FileSlots& s;
+			~SlotGuard() { s.release(); }
+		} guard{*slots};
+		std::ofstream ofs(job.path, std::ios::binary);
+		if (!ofs) throw std::runtime_error("Cannot open file for writing: " + job.path);
+		ofs.write(doc.data(), static_cast<std::streamsize>(doc.size()));
+		ofs.flush();
+		if (!ofs) throw std::runtime_error("Error writing to file: " + job.path);
+		if (doc.capacity() > kMaxRetainedDocument) std::string().swap(doc);
+	});
+}
+
+} // namespace catplot
@@ -0,0 +1,55 @@
+#pragma once
+
+// Drawing-surface interface shared by all output backends.
+//
+// The layout pass (SvgBackend::render_into, Axes::render_to, Figure) is a
+// template over the canvas type, so every primitive call is resolved at
+// compile time. Styling and labels still arrive as strings for every canvas:
+// the layout pass formats colors (rgba_to_css) and tick labels (fmt_num) before
+// the call, so non-SVG canvases pay for those few strings too.
+// A canvas type provides:
+//
+//   void line(double x1, double y1, double x2, double y2, const std::string& stroke, double strokeWidth, const std::string& linecap);
+//   void begin_polyline(const std::string& stroke, double strokeWidth);
+//   void polyline_point(double x, double y);
+//   void end_polyline();
+//   void circle(double cx, double cy, double r, const std::string& fill);
+//   void begin_markers(const std::string& fill, double r);
+//   void marker(double cx, double cy);
+//   void end_markers();
+//   void text(double x, double y, const std::string& content, const std::string& fill, int fontSize, const std::string& anchor, double rotateDeg);
+//   void rect(double x, double y, double w, double h, const std::string& stroke, double strokeWidth, const std::string& fill);
+//   void begin_group_translate(double tx, double ty);
+//   void end_group();
+//
+// Markers are circles of one series streamed with shared styling, like the
+// polyline vertices; a canvas resolves the fill once per series. The per-point
+// calls (polyline_point, marker) carry only coordinates, so the strings are
+// built once per series, tick or label, never per sample.
+//
+// Coordinates are pixels, y pointing down; groups nest and translate
+// everything drawn until the matching end_group. Colors are CSS strings, which
+// RasterCanvas parses back (caching the last one).
+//
+// Implementations:
+//   SvgCanvas          - streams an SVG document (svg_canvas.hpp)
+//   RasterCanvas       - anti-aliased RGBA framebuffer for PNG (raster_canvas.hpp)
+//   DisplayListCanvas  - compact binary op list that can be replayed into any canvas (display_list.hpp)
+//   CountingCanvas     - null sink that only counts primitives and measures extents (counting_canvas.hpp)
+
+namespace catplot {
+
+class SvgCanvas;
+class RasterCanvas;
+class DisplayListCanvas;
+class CountingCanvas;
+
+} // namespace catplot
+
+// Expands X(CanvasType) once per canvas; used for the explicit instantiations
+// of the templated layout code. New backends are added here.
+#define CATPLOT_FOR_EACH_CANVAS(X) \
+	X(SvgCanvas) \
+	X(RasterCanvas) \
+	X(DisplayListCanvas) \
+	X(CountingCanvas)
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "catplot/figure.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace catplot {
+
+// Null sink: draws nothing, only counts primitives and tracks the bounding
+// box of the drawn geometry. Used to time the layout pass on its own and to
+// measure a figure before choosing an output.
+class CountingCanvas {
+public:
+	void line(double x1, double y1, double x2, double y2, const std::string&, double, const std::string& = "round") {
+		++counts.lines;
+		extend(x1, y1);
+		extend(x2, y2);
+	}
+
+	void begin_polyline(const std::string&, double) { ++counts.polylines; }
+	void polyline_point(double x, double y) {
+		++counts.polylinePoints;
+		extend(x, y);
+	}
+	void end_polyline() {}
+
+	void circle(double cx, double cy, double r, const std::string&) {
+		++counts.circles;
+		extend(cx - r, cy - r);
+		extend(cx + r, cy + r);
+	}
+
+	void begin_markers(const std::string&, double r) { markerRadius = r; }
+	void marker(double cx, double cy) {
+		++counts.circles;
+		extend(cx - markerRadius, cy - markerRadius);
+		extend(cx + markerRadius, cy + markerRadius);
+	}
+	void end_markers() {}
+
+	// Only the anchor point is measured; there are no font metrics
+	void text(double x, double y, const std::string& content, const std::string& = "black", int = 12, const std::string& = "start", double = 0.0) {
+		++counts.texts;
+		counts.textChars += content.size();
+		extend(x, y);
+	}
+
+	void rect(double x, double y, double w, double h, const std::string&, double, const std::string& = "none") {
+		++counts.rects;
+		extend(x, y);
+		extend(x + w, y + h);
+	}
+
+	void begin_group_translate(double tx, double ty) {
+		++counts.groups;
+		groups.push_back({tx, ty});
+		offX += tx;
+		offY += ty;
+	}
+	void end_group() {
+		if (groups.empty()) return;
+		offX -= groups.back().first;
+		offY -= groups.back().second;
+		groups.pop_back();
+	}
+
+	const RenderStats& stats() const { return counts; }
+
+private:
+	void extend(double x, double y) {
+		x += offX;
+		y += offY;
+		if (!hasExtent) {
+			counts.minX = counts.maxX = x;
+			counts.minY = counts.maxY = y;
+			hasExtent = true;
+			return;
+		}
+		counts.minX = std::min(counts.minX, x);
+		counts.minY = std::min(counts.minY, y);
+		counts.maxX = std::max(counts.maxX, x);
+		counts.maxY = std::max(counts.maxY, y);
+	}
+
+	RenderStats counts;
+	bool hasExtent{false};
+	double markerRadius{0};
+	double offX{0}, offY{0};
+	std::vector<std::pair<double, double>> groups;
+};
+
+} // namespace catplot
@@ -0,0 +1,48 @@
+#pragma once
+
+// Instruction sets available to the SIMD kernels (simd_minmax, simd_affine).
+// SSE2 is enabled whenever the compiler targets it; AVX2 is compiled per
+// function with CATPLOT_TARGET_AVX2 and selected at run time, so the library
+// itself does not need -mavx2.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CATPLOT_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if CATPLOT_HAVE_SSE2 && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CATPLOT_HAVE_AVX2 1
+#define CATPLOT_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+// A kernel name where its instruction set is compiled in, nullptr elsewhere
+#if CATPLOT_HAVE_SSE2
+#define CATPLOT_SSE2_KERNEL(fn) fn
+#else
+#define CATPLOT_SSE2_KERNEL(fn) nullptr
+#endif
+#if CATPLOT_HAVE_AVX2
+#define CATPLOT_AVX2_KERNEL(fn) fn
+#else
+#define CATPLOT_AVX2_KERNEL(fn) nullptr
+#endif
+
+namespace catplot {
+
+inline bool cpu_has_avx2() {
+#if CATPLOT_HAVE_AVX2
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+// Best kernel for the running CPU; avx2 and sse2 are nullptr when not compiled in
+template<typename Kernel>
+Kernel select_kernel(Kernel avx2, Kernel sse2, Kernel scalar) {
+	if (avx2 && cpu_has_avx2()) return avx2;
+	return sse2 ? sse2 : scalar;
+}
+
+} // namespace catplot
@@ -0,0 +1,111 @@
+#include "density.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace catplot {
+
+namespace {
+
+// Data coordinates to grid cells
+struct CellMap {
+	double xmin, xmax, ymin, ymax;
+	double sx, sy; // data units to cells
+	int cols, rows;
+
+	// Cell index of one sample, or -1 when it falls outside the view. The view
+	// includes its edges, like the marker path; samples on the right and bottom
+	// edges go to the last column and row.
+	std::ptrdiff_t operator()(double x, double y) const {
+		// Negated comparisons also reject NaN
+		if (!(x >= xmin && x <= xmax) || !(y >= ymin && y <= ymax)) return -1;
+		const std::ptrdiff_t cx = std::min(static_cast<std::ptrdiff_t>((x - xmin) * sx), static_cast<std::ptrdiff_t>(cols - 1));
+		const std::ptrdiff_t cy = std::min(static_cast<std::ptrdiff_t>((ymax - y) * sy), static_cast<std::ptrdiff_t>(rows - 1));
+		return cy * cols + cx;
+	}
+};
+
+// Adds samples [first, first + count) of the columns to counts
+inline void bin_range(const SampleColumn& xs, const SampleColumn& ys, std::size_t first, std::size_t count,
+	const CellMap& cell_of, uint32_t* counts) {
+	for_each_block(xs.offset_by(first), ys.offset_by(first), count, [&](std::size_t, const double* px, const double* py, std::size_t m) {
+		for (std::size_t i = 0; i < m; ++i) {
+			std::ptrdiff_t c = cell_of(px[i], py[i]);
+			if (c >= 0) ++counts[c];
+		}
+	});
+}
+
+using Stops = std::array<std::array<uint8_t, 3>, 9>;
+
+// Evenly spaced stops of the matplotlib colormaps
+constexpr Stops kViridis{{
+	{0x44, 0x01, 0x54}, {0x47, 0x2d, 0x7b}, {0x3b, 0x52, 0x8b}, {0x2c, 0x72, 0x8e}, {0x21, 0x91, 0x8c},
+	{0x28, 0xae, 0x80}, {0x5e, 0xc9, 0x62}, {0xad, 0xdc, 0x30}, {0xfd, 0xe7, 0x25}}};
+constexpr Stops kInferno{{
+	{0x00, 0x00, 0x04}, {0x1f, 0x0c, 0x48}, {0x55, 0x0f, 0x6d}, {0x88, 0x22, 0x6a}, {0xba, 0x36, 0x55},
+	{0xe3, 0x59, 0x33}, {0xf9, 0x8e, 0x09}, {0xf9, 0xcb, 0x35}, {0xfc, 0xff, 0xa4}}};
+constexpr Stops kGrays{{
+	{0xe6, 0xe6, 0xe6}, {0xc9, 0xc9, 0xc9}, {0xac, 0xac, 0xac}, {0x8f, 0x8f, 0x8f}, {0x73, 0x73, 0x73},
+	{0x56, 0x56, 0x56}, {0x39, 0x39, 0x39}, {0x1c, 0x1c, 0x1c}, {0x00, 0x00, 0x00}}};
+
+} // namespace
+
+DensityGrid bin_density(const SampleColumn& xs, const SampleColumn& ys, std::size_t n,
+	double xmin, double xmax, double ymin, double ymax,
+	double width, double height, int binPx, bool parallel, std::pmr::memory_resource* scratch) {
+	DensityGrid grid{0, 0, std::pmr::vector<uint32_t>(scratch), 0};
+	if (width <= 0.0 || height <= 0.0 || binPx < 1) return grid;
+	grid.cols = static_cast<int>(std::ceil(width / binPx));
+	grid.rows = static_cast<int>(std::ceil(height / binPx));
+	const std::size_t cells = static_cast<std::size_t>(grid.cols) * grid.rows;
+	grid.counts.assign(cells, 0);
+	if (xmax == xmin || ymax == ymin) return grid;
+	const CellMap cell_of{xmin, xmax, ymin, ymax, width / (xmax - xmin) / binPx, height / (ymax - ymin) / binPx, grid.cols, grid.rows};
+	uint32_t* counts = grid.counts.data();
+
+	bool binned = false;
+#ifdef _OPENMP
+	// Below this the per-thread grids cost more than the points
+	if (parallel && n >= cells && omp_get_max_threads() > 1) {
+		// Work is split in whole conversion blocks
+		const std::ptrdiff_t blocks = static_cast<std::ptrdiff_t>((n + kMapBlock - 1) / kMapBlock);
+		#pragma omp parallel
+		{
+			// Thread-private, so not from the (single-threaded) scratch resource
+			std::vector<uint32_t> local(cells, 0);
+			#pragma omp for schedule(static) nowait
+			for (std::ptrdiff_t b = 0; b < blocks; ++b) {
+				const std::size_t first = static_cast<std::size_t>(b) * kMapBlock;
+				bin_range(xs, ys, first, std::min(kMapBlock, n - first), cell_of, local.data());
+			}
+			#pragma omp critical(catplot_density_merge)
+			for (std::size_t c = 0; c < cells; ++c) counts[c] += local[c];
+		}
+		binned = true;
+	}
+#else
+	(void)parallel;
+#endif
+	if (!binned) bin_range(xs, ys, 0, n, cell_of, counts);
+	grid.maxCount = cells == 0 ? 0 : *std::max_element(grid.counts.begin(), grid.counts.end());
+	return grid;
+}
+
+Rgba colormap_color(Colormap map, double t) {
+	const Stops& stops = map == Colormap::Inferno ? kInferno : map == Colormap::Grays ? kGrays : kViridis;
+	t = std::clamp(t, 0.0, 1.0) * (stops.size() - 1);
+	std::size_t i = std::min(static_cast<std::size_t>(t), stops.size() - 2);
+	double f = t - i;
+	Rgba c;
+	c.r = (stops[i][0] + f * (stops[i + 1][0] - stops[i][0])) / 255.0;
+	c.g = (stops[i][1] + f * (stops[i + 1][1] - stops[i][1])) / 255.0;
+	c.b = (stops[i][2] + f * (stops[i + 1][2] - stops[i][2])) / 255.0;
+	return c;
+}
+
+} // namespace catplot
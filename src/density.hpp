@@ -0,0 +1,33 @@
+#pragma once
+
+#include "catplot/axes.hpp"
+#include "series_span.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace catplot {
+
+// Point counts of a scatter series per binPx x binPx cell of the plot area,
+// row-major from the top-left cell
+struct DensityGrid {
+	int cols{0};
+	int rows{0};
+	std::pmr::vector<uint32_t> counts;
+	uint32_t maxCount{0};
+};
+
+// Bins points into a grid covering a width x height plot area whose edges map
+// to [xmin, xmax] and [ymax, ymin] (y grows downward). Points outside that
+// range, edges included as for markers, and NaN samples are dropped. The columns are read in place, in any element
+// type. With `parallel` every thread fills its own bins, which are summed at the
+// end. The grid is allocated from `scratch`.
+DensityGrid bin_density(const SampleColumn& xs, const SampleColumn& ys, std::size_t n,
+	double xmin, double xmax, double ymin, double ymax,
+	double width, double height, int binPx, bool parallel, std::pmr::memory_resource* scratch);
+
+// Colormap sample for t in [0, 1]
+Rgba colormap_color(Colormap map, double t);
+
+} // namespace catplot
@@ -0,0 +1,118 @@
+#include "display_list.hpp"
+
+namespace catplot {
+
+DisplayListCanvas::DisplayListCanvas(int width, int height)
+	: widthPx(width), heightPx(height) {
+	put_raw("CPDL", 4);
+	put_u32(kVersion);
+	put_i32(width);
+	put_i32(height);
+}
+
+uint32_t DisplayListCanvas::intern(const std::string& s) {
+	auto it = strings.find(s);
+	if (it != strings.end()) return it->second;
+	uint32_t idx = static_cast<uint32_t>(strings.size());
+	strings.emplace(s, idx);
+	put_op(Op::DefineString);
+	put_u32(static_cast<uint32_t>(s.size()));
+	put_raw(s.data(), s.size());
+	return idx;
+}
+
+void DisplayListCanvas::line(double x1, double y1, double x2, double y2, const std::string& stroke, double strokeWidth, const std::string& linecap) {
+	// Strings are interned first so their definitions precede the op that uses them
+	uint32_t s = intern(stroke);
+	uint32_t cap = intern(linecap);
+	put_op(Op::Line);
+	put_f64(x1);
+	put_f64(y1);
+	put_f64(x2);
+	put_f64(y2);
+	put_u32(s);
+	put_f64(strokeWidth);
+	put_u32(cap);
+}
+
+void DisplayListCanvas::begin_polyline(const std::string& stroke, double strokeWidth) {
+	uint32_t s = intern(stroke);
+	put_op(Op::BeginPolyline);
+	put_u32(s);
+	put_f64(strokeWidth);
+}
+
+void DisplayListCanvas::polyline_point(double x, double y) {
+	put_op(Op::PolylinePoint);
+	put_f64(x);
+	put_f64(y);
+}
+
+void DisplayListCanvas::end_polyline() {
+	put_op(Op::EndPolyline);
+}
+
+void DisplayListCanvas::circle(double cx, double cy, double r, const std::string& fill) {
+	uint32_t f = intern(fill);
+	put_op(Op::Circle);
+	put_f64(cx);
+	put_f64(cy);
+	put_f64(r);
+	put_u32(f);
+}
+
+void DisplayListCanvas::begin_markers(const std::string& fill, double r) {
+	uint32_t f = intern(fill);
+	put_op(Op::BeginMarkers);
+	put_u32(f);
+	put_f64(r);
+}
+
+void DisplayListCanvas::marker(double cx, double cy) {
+	put_op(Op::Marker);
+	put_f64(cx);
+	put_f64(cy);
+}
+
+void DisplayListCanvas::end_markers() {
+	put_op(Op::EndMarkers);
+}
+
+void DisplayListCanvas::text(double x, double y, const std::string& content, const std::string& fill, int fontSize, const std::string& anchor, double rotateDeg) {
+	uint32_t c = intern(content);
+	uint32_t f = intern(fill);
+	uint32_t a = intern(anchor);
+	put_op(Op::Text);
+	put_f64(x);
+	put_f64(y);
+	put_u32(c);
+	put_u32(f);
+	put_i32(fontSize);
+	put_u32(a);
+	put_f64(rotateDeg);
+}
+
+void DisplayListCanvas::rect(double x, double y, double w, double h, const std::string& stroke, double strokeWidth, const std::string& fill) {
+	uint32_t s = intern(stroke);
+	uint32_t f = intern(fill);
+	put_op(Op::Rect);
+	put_f64(x);
+	put_f64(y);
+	put_f64(w);
+	put_f64(h);
+	put_u32(s);
+	put_f64(strokeWidth);
+	put_u32(f);
+}
+
+void DisplayListCanvas::begin_group_translate(double tx, double ty) {
+	put_op(Op::BeginGroupTranslate);
+	put_f64(tx);
+	put_f64(ty);
+}
+
+void DisplayListCanvas::end_group() {
+	put_op(Op::EndGroup);
+}
+
+} // namespace catplot
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace catplot {
+
+// Records canvas primitives into a compact binary op list that can later be
+// replayed into any other canvas (SVG, raster, ...), so one layout pass can
+// feed several outputs.
+//
+// Format: "CPDL", u32 version, i32 width, i32 height, then a sequence of ops.
+// Each op is one opcode byte followed by its operands: doubles as 8 raw bytes,
+// ints as 4 raw bytes (host byte order, the list is meant for in-process and
+// same-machine caching), strings as a u32 index into a table that is built
+// inline by DefineString ops the first time a string is used.
+class DisplayListCanvas {
+public:
+	enum class Op : uint8_t {
+		DefineString = 1,
+		Line,
+		BeginPolyline,
+		PolylinePoint,
+		EndPolyline,
+		Circle,
+		Text,
+		Rect,
+		BeginGroupTranslate,
+		EndGroup,
+		BeginMarkers,
+		Marker,
+		EndMarkers
+	};
+
+	static constexpr uint32_t kVersion = 1;
+
+	DisplayListCanvas(int widthPx, int heightPx);
+
+	void line(double x1, double y1, double x2, double y2, const std::string& stroke, double strokeWidth, const std::string& linecap = "round");
+
+	void begin_polyline(const std::string& stroke, double strokeWidth);
+	void polyline_point(double x, double y);
+	void end_polyline();
+
+	void circle(double cx, double cy, double r, const std::string& fill);
+
+	void begin_markers(const std::string& fill, double r);
+	void marker(double cx, double cy);
+	void end_markers();
+
+	void text(double x, double y, const std::string& content, const std::string& fill = "black", int fontSize = 12, const std::string& anchor = "start", double rotateDeg = 0.0);
+
+	void rect(double x, double y, double w, double h, const std::string& stroke, double strokeWidth, const std::string& fill = "none");
+
+	void begin_group_translate(double tx, double ty);
+	void end_group();
+
+	int width() const { return widthPx; }
+	int height() const { return heightPx; }
+	const std::vector<uint8_t>& bytes() const { return buf; }
+
+	// Issue the recorded primitives, in order, on `canvas`
+	template<typename CanvasT>
+	void replay(CanvasT& canvas) const { replay(buf.data(), buf.size(), canvas); }
+
+	// Replay a list produced by bytes(); throws std::runtime_error if it is malformed
+	template<typename CanvasT>
+	static void replay(const uint8_t* data, std::size_t size, CanvasT& canvas);
+
+private:
+	void put_op(Op op) { buf.push_back(static_cast<uint8_t>(op)); }
+	void put_f64(double v) { put_raw(&v, sizeof v); }
+	void put_i32(int32_t v) { put_raw(&v, sizeof v); }
+	void put_u32(uint32_t v) { put_raw(&v, sizeof v); }
+	void put_raw(const void* p, std::size_t n) {
+		const uint8_t* b = static_cast<const uint8_t*>(p);
+		buf.insert(buf.end(), b, b + n);
+	}
+	// Index of `s` in the string table, emitting a DefineString op on first use
+	uint32_t intern(const std::string& s);
+
+	class Reader;
+
+	int widthPx;
+	int heightPx;
+	std::vector<uint8_t> buf;
+	std::unordered_map<std::string, uint32_t> strings;
+};
+
+class DisplayListCanvas::Reader {
+public:
+	Reader(const uint8_t* data, std::size_t size) : p(data), end(data + size) {}
+
+	bool done() const { return p == end; }
+	uint8_t u8() { need(1); return *p++; }
+	double f64() { double v; raw(&v, sizeof v); return v; }
+	int32_t i32() { int32_t v; raw(&v, sizeof v); return v; }
+	uint32_t u32() { uint32_t v; raw(&v, sizeof v); return v; }
+	std::string str(uint32_t len) {
+		need(len);
+		std::string s(reinterpret_cast<const char*>(p), len);
+		p += len;
+		return s;
+	}
+	const std::string& ref(const std::vector<std::string>& table) {
+		uint32_t i = u32();
+		if (i >= table.size()) throw std::runtime_error("Display list references undefined string");
+		return table[i];
+	}
+
+private:
+	void need(std::size_t n) const {
+		if (static_cast<std::size_t>(end - p) < n) throw std::runtime_error("Display list is truncated");
+	}
+	void raw(void* out, std::size_t n) {
+		need(n);
+		std::memcpy(out, p, n);
+		p += n;
+	}
+
+	const uint8_t* p;
+	const uint8_t* end;
+};
+
+template<typename CanvasT>
+void DisplayListCanvas::replay(const uint8_t* data, std::size_t size, CanvasT& canvas) {
+	Reader in(data, size);
+	if (in.str(4) != "CPDL") throw std::runtime_error("Not a catplot display list");
+	if (in.u32() != kVersion) throw std::runtime_error("Unsupported display list version");
+	in.i32(); // width
+	in.i32(); // height
+	std::vector<std::string> table;
+	while (!in.done()) {
+		switch (static_cast<Op>(in.u8())) {
+		case Op::DefineString:
+			table.push_back(in.str(in.u32()));
+			break;
+		case Op::Line: {
+			double x1 = in.f64(), y1 = in.f64(), x2 = in.f64(), y2 = in.f64();
+			const std::string& stroke = in.ref(table);
+			double width = in.f64();
+			canvas.line(x1, y1, x2, y2, stroke, width, in.ref(table));
+			break;
+		}
+		case Op::BeginPolyline: {
+			const std::string& stroke = in.ref(table);
+			canvas.begin_polyline(stroke, in.f64());
+			break;
+		}
+		case Op::PolylinePoint: {
+			double x = in.f64();
+			canvas.polyline_point(x, in.f64());
+			break;
+		}
+		case Op::EndPolyline:
+			canvas.end_polyline();
+			break;
+		case Op::Circle: {
+			double cx = in.f64(), cy = in.f64(), r = in.f64();
+			canvas.circle(cx, cy, r, in.ref(table));
+			break;
+		}
+		case Op::Text: {
+			double x = in.f64(), y = in.f64();
+			const std::string& content = in.ref(table);
+			const std::string& fill = in.ref(table);
+			int fontSize = in.i32();
+			const std::string& anchor = in.ref(table);
+			canvas.text(x, y, content, fill, fontSize, anchor, in.f64());
+			break;
+		}
+		case Op::Rect: {
+			double x = in.f64(), y = in.f64(), w = in.f64(), h = in.f64();
+			const std::string& stroke = in.ref(table);
+			double width = in.f64();
+			canvas.rect(x, y, w, h, stroke, width, in.ref(table));
+			break;
+		}
+		case Op::BeginGroupTranslate: {
+			double tx = in.f64();
+			canvas.begin_group_translate(tx, in.f64());
+			break;
+		}
+		case Op::EndGroup:
+			canvas.end_group();
+			break;
+		case Op::BeginMarkers: {
+			const std::string& fill = in.ref(table);
+			canvas.begin_markers(fill, in.f64());
+			break;
+		}
+		case Op::Marker: {
+			double cx = in.f64();
+			canvas.marker(cx, in.f64());
+			break;
+		}
+		case Op::EndMarkers:
+			canvas.end_markers();
+			break;
+		default:
+			throw std::runtime_error("Unknown display list op");
+		}
+	}
+}
+
+} // namespace catplot
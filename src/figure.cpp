@@ -1,8 +1,17 @@
 #include "catplot/figure.hpp"
 #include "catplot/axes.hpp"
 #include "svg_canvas.hpp"
+#include "raster_canvas.hpp"
+#include "counting_canvas.hpp"
+#include "display_list.hpp"
+#include "thread_pool.hpp"
+#include "png_writer.hpp"
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 
 namespace catplot {
 
@@ -11,6 +20,10 @@ Figure::Figure(int width_px, int height_px)
 		ensure_grid(1, 1);
 }
 
+Figure::~Figure() = default;
+Figure::Figure(Figure&&) noexcept = default;
+Figure& Figure::operator=(Figure&&) noexcept = default;
+
 Axes& Figure::axes() {
 	return *axesGrid[0];
 }
@@ -36,28 +49,155 @@ int Figure::height() const {
 	return heightPx;
 }
 
-void Figure::save(const std::string& filepath) const {
-	SvgCanvas canvas(widthPx, heightPx);
+template<typename CanvasT>
+void Figure::render_cells(CanvasT& canvas, ThreadPool* cellPool) const {
 	// layout cells
 	double cellW = static_cast<double>(widthPx) / gridRows; // deliberate typical row/col orientation correction below
 	double cellH = static_cast<double>(heightPx) / gridCols;
 	// Correct: width divided by cols, height by rows
 	cellW = static_cast<double>(widthPx) / gridCols;
 	cellH = static_cast<double>(heightPx) / gridRows;
-	for (int r = 0; r < gridRows; ++r) {
-		for (int c = 0; c < gridCols; ++c) {
-			size_t idx = static_cast<size_t>(r * gridCols + c);
-			double x = c * cellW;
-			double y = r * cellH;
-			axesGrid[idx]->render_to(canvas, x, y, cellW, cellH);
+	auto renderCell = [&](size_t idx, auto& target) {
+		int r = static_cast<int>(idx) / gridCols;
+		int c = static_cast<int>(idx) % gridCols;
+		double x = c * cellW;
+		double y = r * cellH;
+		axesGrid[idx]->render_to(target, x, y, cellW, cellH);
+	};
+	const size_t cells = axesGrid.size();
+	if constexpr (std::is_same_v<CanvasT, SvgCanvas>) {
+		if (renderCache) {
+			// Unchanged subplots return their fragment from the previous save
+			std::vector<const std::string*> fragments(cells);
+			auto fetch = [&](size_t idx) {
+				int r = static_cast<int>(idx) / gridCols;
+				int c = static_cast<int>(idx) % gridCols;
+				fragments[idx] = &axesGrid[idx]->cached_svg_fragment(c * cellW, r * cellH, cellW, cellH, canvas.precision());
+			};
+			if (cellPool && cells > 1) cellPool->parallel_for(cells, fetch);
+			else for (size_t idx = 0; idx < cells; ++idx) fetch(idx);
+			for (const std::string* f : fragments) canvas.write_fragment(f->data(), f->size());
+			return;
 		}
 	}
+	if (!cellPool || cells < 2) {
+		for (size_t idx = 0; idx < cells; ++idx) renderCell(idx, canvas);
+		return;
+	}
+	// Cells are laid out concurrently into private buffers, then emitted in grid
+	// order so the result matches the serial pass byte for byte
+	if constexpr (std::is_same_v<CanvasT, SvgCanvas>) {
+		std::vector<std::string> fragments(cells);
+		cellPool->parallel_for(cells, [&](size_t idx) {
+			SvgCanvas part(SvgCanvas::Fragment{}, [&fragments, idx](const char* data, size_t n) { fragments[idx].append(data, n); });
+			part.set_precision(canvas.precision());
+			renderCell(idx, part);
+			part.finish();
+		});
+		for (const auto& f : fragments) canvas.write_fragment(f.data(), f.size());
+	} else {
+		// Other canvases replay a display list; the layout work still runs in parallel
+		std::vector<DisplayListCanvas> lists;
+		lists.reserve(cells);
+		for (size_t idx = 0; idx < cells; ++idx) lists.emplace_back(widthPx, heightPx);
+		cellPool->parallel_for(cells, [&](size_t idx) { renderCell(idx, lists[idx]); });
+		for (const auto& l : lists) l.replay(canvas);
+	}
+}
+
+void Figure::set_svg_precision(int significantDigits) {
+	if (significantDigits < 1 || significantDigits > NumberFormatter::kMaxPrecision) throw std::out_of_range("SVG precision out of range");
+	svgPrecision = significantDigits;
+}
+
+int Figure::svg_precision() const { return svgPrecision; }
+
+void Figure::set_render_threads(int threads) {
+	if (threads < 0) throw std::out_of_range("Render thread count must be non-negative");
+	unsigned n = threads > 0 ? static_cast<unsigned>(threads) : std::max(1u, std::thread::hardware_concurrency());
+	renderThreads = threads;
+	// The calling thread takes part, so n threads need n - 1 workers
+	pool = n > 1 ? std::make_unique<ThreadPool>(n - 1) : nullptr;
+}
+
+int Figure::render_threads() const { return renderThreads; }
+
+void Figure::save(const std::string& filepath) const {
 	std::ofstream ofs(filepath, std::ios::binary);
-	ofs << canvas.str();
+	if (!ofs) {
+		throw std::runtime_error("Cannot open file for writing: " + filepath);
+	}
+	save(ofs);
+	ofs.flush();
+	if (!ofs) {
+		throw std::runtime_error("Error writing to file: " + filepath);
+	}
+}
+
+void Figure::save(std::ostream& out) const {
+	// Elements are streamed through the canvas' bounded buffer, so the full
+	// document is never held in memory
+	SvgCanvas canvas(widthPx, heightPx, out);
+	write_svg(canvas, pool.get());
+}
+
+void Figure::write_svg(SvgCanvas& canvas, ThreadPool* cellPool) const {
+	canvas.set_precision(svgPrecision);
+	render_cells(canvas, cellPool);
+	canvas.finish();
 }
 
 void Figure::save_png(const std::string& filepath) const {
-	throw std::runtime_error("PNG export not implemented yet. Planned: raster backend integration.");
+	std::ofstream ofs(filepath, std::ios::binary);
+	if (!ofs) {
+		throw std::runtime_error("Cannot open file for writing: " + filepath);
+	}
+	save_png(ofs);
+	ofs.flush();
+	if (!ofs) {
+		throw std::runtime_error("Error writing to file: " + filepath);
+	}
+}
+
+void Figure::save_png(std::ostream& out) const {
+	RasterCanvas canvas(widthPx, heightPx);
+	render_cells(canvas, pool.get());
+	write_png(out, canvas.pixels(), canvas.width(), canvas.height());
+}
+
+void Figure::set_render_cache(bool enabled) {
+	renderCache = enabled;
+	// Dropping the fragments releases their memory
+	if (!enabled) for (auto& ax : axesGrid) ax->renderCache.clear();
+}
+
+bool Figure::render_cache() const { return renderCache; }
+
+RenderCacheStats Figure::render_cache_stats() const {
+	RenderCacheStats total;
+	for (const auto& ax : axesGrid) {
+		RenderCacheStats s = ax->render_cache_stats();
+		total.hits += s.hits;
+		total.misses += s.misses;
+	}
+	return total;
+}
+
+ArenaStats Figure::last_render_arena() const {
+	ArenaStats total;
+	for (const auto& ax : axesGrid) {
+		ArenaStats a = ax->last_render_arena();
+		total.allocations += a.allocations;
+		total.bytes += a.bytes;
+		total.blocks += a.blocks;
+	}
+	return total;
+}
+
+RenderStats Figure::measure() const {
+	CountingCanvas canvas;
+	render_cells(canvas, pool.get());
+	return canvas.stats();
 }
 
 void Figure::ensure_grid(int r, int c) {
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+namespace catplot {
+
+// Locale-independent double formatter used for every number the SVG backend
+// emits. Output matches iostream's default formatting ("%.<precision>g"), so
+// precision 6 reproduces what `ostream << double` used to write.
+class NumberFormatter {
+public:
+	// Longest output for precision <= kMaxPrecision: sign, digits, point, exponent
+	static constexpr std::size_t kMaxChars = 32;
+	static constexpr int kMaxPrecision = 17;
+
+	explicit NumberFormatter(int significantDigits = 6) { set_precision(significantDigits); }
+
+	void set_precision(int significantDigits) { digits = std::clamp(significantDigits, 1, kMaxPrecision); }
+	int precision() const { return digits; }
+
+	// Write v to out (at least kMaxChars bytes) and return the number of characters written
+	std::size_t format(double v, char* out) const {
+#if defined(__cpp_lib_to_chars) || (defined(_MSC_VER) && _MSC_VER >= 1924)
+		auto res = std::to_chars(out, out + kMaxChars, v, std::chars_format::general, digits);
+		return static_cast<std::size_t>(res.ptr - out);
+#else
+		int n = std::snprintf(out, kMaxChars, "%.*g", digits, v);
+		return n > 0 ? static_cast<std::size_t>(n) : 0;
+#endif
+	}
+
+private:
+	int digits{6};
+};
+
+} // namespace catplot
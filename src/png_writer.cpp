@@ -0,0 +1,266 @@
+#include "png_writer.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace catplot {
+
+namespace {
+
+// --- checksums ---
+
+const std::array<uint32_t, 256>& crc_table() {
+	static const std::array<uint32_t, 256> table = [] {
+		std::array<uint32_t, 256> t{};
+		for (uint32_t n = 0; n < 256; ++n) {
+			uint32_t c = n;
+			for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			t[n] = c;
+		}
+		return t;
+	}();
+	return table;
+}
+
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, std::size_t size) {
+	const auto& table = crc_table();
+	for (std::size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return crc;
+}
+
+uint32_t adler32(const uint8_t* data, std::size_t size) {
+	const uint32_t mod = 65521;
+	uint32_t a = 1, b = 0;
+	while (size > 0) {
+		// 5552 is the largest block that cannot overflow 32 bits before the modulo
+		std::size_t block = std::min<std::size_t>(size, 5552);
+		size -= block;
+		while (block--) { a += *data++; b += a; }
+		a %= mod;
+		b %= mod;
+	}
+	return (b << 16) | a;
+}
+
+// --- deflate ---
+
+class BitWriter {
+public:
+	explicit BitWriter(std::vector<uint8_t>& sink) : out(sink) {}
+
+	// Append `count` bits of `bits`, least significant bit first
+	void put(uint32_t bits, int count) {
+		acc |= static_cast<uint64_t>(bits) << used;
+		used += count;
+		while (used >= 8) {
+			out.push_back(static_cast<uint8_t>(acc & 0xFF));
+			acc >>= 8;
+			used -= 8;
+		}
+	}
+
+	// Huffman codes are defined most significant bit first
+	void put_code(uint32_t code, int length) {
+		uint32_t rev = 0;
+		for (int i = 0; i < length; ++i) rev |= ((code >> i) & 1u) << (length - 1 - i);
+		put(rev, length);
+	}
+
+	void flush() {
+		if (used > 0) out.push_back(static_cast<uint8_t>(acc & 0xFF));
+		acc = 0;
+		used = 0;
+	}
+
+private:
+	std::vector<uint8_t>& out;
+	uint64_t acc{0};
+	int used{0};
+};
+
+const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Fixed literal/length Huffman code (RFC 1951, 3.2.6)
+void put_literal(BitWriter& bw, int sym) {
+	if (sym < 144) bw.put_code(0x30 + sym, 8);
+	else if (sym < 256) bw.put_code(0x190 + (sym - 144), 9);
+	else if (sym < 280) bw.put_code(sym - 256, 7);
+	else bw.put_code(0xC0 + (sym - 280), 8);
+}
+
+void put_match(BitWriter& bw, int length, int distance) {
+	int li = 28;
+	while (kLengthBase[li] > length) --li;
+	put_literal(bw, 257 + li);
+	if (kLengthExtra[li]) bw.put(static_cast<uint32_t>(length - kLengthBase[li]), kLengthExtra[li]);
+	int di = 29;
+	while (kDistBase[di] > distance) --di;
+	bw.put_code(static_cast<uint32_t>(di), 5);
+	if (kDistExtra[di]) bw.put(static_cast<uint32_t>(distance - kDistBase[di]), kDistExtra[di]);
+}
+
+constexpr int kWindow = 32768;
+constexpr int kHashBits = 15;
+constexpr int kMinMatch = 3;
+constexpr int kMaxMatch = 258;
+constexpr int kMaxChain = 32;
+// Stop searching once a match is this long (zlib's nice_length)
+constexpr int kNiceMatch = 128;
+// Longer matches only hash their last position (zlib's max_insert_length);
+// keeps long runs of background pixels cheap
+constexpr int kMaxInsert = 16;
+
+inline uint32_t hash3(const uint8_t* p) {
+	uint32_t v = (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+	return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+} // namespace
+
+std::vector<uint8_t> zlib_compress(const uint8_t* data, std::size_t size) {
+	std::vector<uint8_t> out;
+	out.reserve(size / 4 + 64);
+	out.push_back(0x78); // CMF: deflate, 32K window
+	out.push_back(0x01); // FLG: fastest level, check bits
+	BitWriter bw(out);
+	bw.put(1, 1); // BFINAL
+	bw.put(1, 2); // BTYPE = fixed Huffman
+
+	std::vector<int32_t> head(static_cast<std::size_t>(1) << kHashBits, -1);
+	std::vector<int32_t> prev(kWindow, -1);
+	auto insert = [&](std::size_t pos) {
+		uint32_t h = hash3(data + pos);
+		prev[pos & (kWindow - 1)] = head[h];
+		head[h] = static_cast<int32_t>(pos);
+	};
+
+	std::size_t i = 0;
+	while (i < size) {
+		int bestLen = 0;
+		int bestDist = 0;
+		if (i + kMinMatch <= size) {
+			int32_t cand = head[hash3(data + i)];
+			int maxLen = static_cast<int>(std::min<std::size_t>(kMaxMatch, size - i));
+			for (int chain = 0; cand >= 0 && chain < kMaxChain; ++chain) {
+				std::size_t dist = i - static_cast<std::size_t>(cand);
+				if (dist == 0 || dist > static_cast<std::size_t>(kWindow - 1)) break;
+				const uint8_t* a = data + cand;
+				const uint8_t* b = data + i;
+				if (a[bestLen] == b[bestLen]) {
+					int len = 0;
+					while (len < maxLen && a[len] == b[len]) ++len;
+					if (len > bestLen) {
+						bestLen = len;
+						bestDist = static_cast<int>(dist);
+						if (len == maxLen) break;
+					}
+				}
+				int32_t next = prev[static_cast<std::size_t>(cand) & (kWindow - 1)];
+				if (next >= cand) break; // slot was overwritten by a newer position
+				cand = next;
+			}
+		}
+		if (bestLen >= kMinMatch) {
+			put_match(bw, bestLen, bestDist);
+			std::size_t end = i + static_cast<std::size_t>(bestLen);
+			if (bestLen > kMaxInsert) i = end - 1;
+			for (; i < end; ++i) {
+				if (i + kMinMatch <= size) insert(i);
+			}
+		} else {
+			put_literal(bw, data[i]);
+			if (i + kMinMatch <= size) insert(i);
+			++i;
+		}
+	}
+	put_literal(bw, 256); // end of block
+	bw.flush();
+
+	uint32_t adler = adler32(data, size);
+	out.push_back(static_cast<uint8_t>(adler >> 24));
+	out.push_back(static_cast<uint8_t>(adler >> 16));
+	out.push_back(static_cast<uint8_t>(adler >> 8));
+	out.push_back(static_cast<uint8_t>(adler));
+	return out;
+}
+
+namespace {
+
+void put_u32(std::vector<uint8_t>& v, uint32_t x) {
+	v.push_back(static_cast<uint8_t>(x >> 24));
+	v.push_back(static_cast<uint8_t>(x >> 16));
+	v.push_back(static_cast<uint8_t>(x >> 8));
+	v.push_back(static_cast<uint8_t>(x));
+}
+
+void write_chunk(std::ostream& out, const char type[4], const std::vector<uint8_t>& payload) {
+	std::vector<uint8_t> head;
+	put_u32(head, static_cast<uint32_t>(payload.size()));
+	head.insert(head.end(), type, type + 4);
+	uint32_t crc = crc32_update(0xFFFFFFFFu, reinterpret_cast<const uint8_t*>(type), 4);
+	crc = crc32_update(crc, payload.data(), payload.size()) ^ 0xFFFFFFFFu;
+	std::vector<uint8_t> tail;
+	put_u32(tail, crc);
+	out.write(reinterpret_cast<const char*>(head.data()), static_cast<std::streamsize>(head.size()));
+	out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+	out.write(reinterpret_cast<const char*>(tail.data()), static_cast<std::streamsize>(tail.size()));
+}
+
+} // namespace
+
+void write_png(std::ostream& out, const uint8_t* rgba, int width, int height) {
+	if (width <= 0 || height <= 0) throw std::invalid_argument("PNG dimensions must be positive");
+	const std::size_t stride = static_cast<std::size_t>(width) * 4;
+
+	// Per-row filter choice: None, Sub or Up, whichever has the smallest sum of
+	// absolute residuals (the usual libpng heuristic, restricted to cheap filters)
+	std::vector<uint8_t> filtered((stride + 1) * static_cast<std::size_t>(height));
+	std::vector<uint8_t> sub(stride), up(stride);
+	for (int y = 0; y < height; ++y) {
+		const uint8_t* row = rgba + static_cast<std::size_t>(y) * stride;
+		const uint8_t* above = y > 0 ? row - stride : nullptr;
+		uint8_t* dst = filtered.data() + static_cast<std::size_t>(y) * (stride + 1);
+		// Residuals are scored as signed bytes
+		auto cost = [](uint8_t v) { return v < 128 ? v : 256 - v; };
+		long costNone = 0, costSub = 0, costUp = 0;
+		for (std::size_t i = 0; i < stride; ++i) {
+			sub[i] = static_cast<uint8_t>(row[i] - (i >= 4 ? row[i - 4] : 0));
+			up[i] = static_cast<uint8_t>(row[i] - (above ? above[i] : 0));
+			costNone += cost(row[i]);
+			costSub += cost(sub[i]);
+			costUp += cost(up[i]);
+		}
+		const uint8_t* best = row;
+		dst[0] = 0;
+		if (costUp <= costSub && costUp <= costNone) {
+			dst[0] = 2;
+			best = up.data();
+		} else if (costSub <= costNone) {
+			dst[0] = 1;
+			best = sub.data();
+		}
+		std::memcpy(dst + 1, best, stride);
+	}
+
+	static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	out.write(reinterpret_cast<const char*>(signature), 8);
+
+	std::vector<uint8_t> ihdr;
+	put_u32(ihdr, static_cast<uint32_t>(width));
+	put_u32(ihdr, static_cast<uint32_t>(height));
+	ihdr.push_back(8); // bit depth
+	ihdr.push_back(6); // color type RGBA
+	ihdr.push_back(0); // compression
+	ihdr.push_back(0); // filter
+	ihdr.push_back(0); // interlace
+	write_chunk(out, "IHDR", ihdr);
+	write_chunk(out, "IDAT", zlib_compress(filtered.data(), filtered.size()));
+	write_chunk(out, "IEND", {});
+}
+
+} // namespace catplot
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace catplot {
+
+// Minimal zlib/deflate encoder: LZ77 with hash chains and fixed Huffman codes
+std::vector<uint8_t> zlib_compress(const uint8_t* data, std::size_t size);
+
+// Write an 8-bit RGBA image (rows top to bottom, no padding) as a PNG file
+void write_png(std::ostream& out, const uint8_t* rgba, int width, int height);
+
+} // namespace catplot
@@ -0,0 +1,316 @@
+#include "raster_canvas.hpp"
+#include "bitmap_font.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace catplot {
+
+namespace {
+
+float clamp01(double v) {
+	return static_cast<float>(v < 0.0 ? 0.0 : (v > 1.0 ? 1.0 : v));
+}
+
+// Length of the overlap between pixel [p, p+1) and the interval [a, b)
+double span_overlap(int p, double a, double b) {
+	return std::max(0.0, std::min(p + 1.0, b) - std::max(static_cast<double>(p), a));
+}
+
+// Pixel index for an already rounded coordinate, clamped to [lo, hi] before the
+// cast so far-off or non-finite values stay defined (NaN maps to lo)
+int clamp_pixel(double v, int lo, int hi) {
+	if (!(v > lo)) return lo;
+	if (v > hi) return hi;
+	return static_cast<int>(v);
+}
+
+} // namespace
+
+RasterCanvas::RasterCanvas(int width, int height)
+	: widthPx(width), heightPx(height),
+	  rgba(static_cast<std::size_t>(std::max(0, width)) * static_cast<std::size_t>(std::max(0, height)) * 4, 255),
+	  maskX0(width), maskY0(height), maskX1(-1), maskY1(-1) {}
+
+const RasterCanvas::Color& RasterCanvas::resolve(const std::string& css) {
+	if (css == cachedCss && !cachedCss.empty()) return cachedColor;
+	Color c;
+	std::string s;
+	s.reserve(css.size());
+	for (char ch : css) if (!std::isspace(static_cast<unsigned char>(ch))) s += static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+	if (s == "black") c = {0, 0, 0, 1};
+	else if (s == "white") c = {1, 1, 1, 1};
+	else if (s == "red") c = {1, 0, 0, 1};
+	else if (s == "green") c = {0, 128.0f / 255.0f, 0, 1};
+	else if (s == "blue") c = {0, 0, 1, 1};
+	else if (s.size() == 7 && s[0] == '#') {
+		long v = std::strtol(s.c_str() + 1, nullptr, 16);
+		c = {((v >> 16) & 0xFF) / 255.0f, ((v >> 8) & 0xFF) / 255.0f, (v & 0xFF) / 255.0f, 1};
+	} else if (s.rfind("rgb", 0) == 0) {
+		// rgb(r,g,b) or rgba(r,g,b,a) with 0..255 channels and 0..1 alpha
+		std::size_t open = s.find('(');
+		double v[4] = {0, 0, 0, 1};
+		const char* p = s.c_str() + (open == std::string::npos ? s.size() : open + 1);
+		for (int k = 0; k < 4 && *p; ++k) {
+			char* end = nullptr;
+			v[k] = std::strtod(p, &end);
+			if (end == p) break;
+			p = end;
+			if (*p == ',') ++p;
+		}
+		c = {clamp01(v[0] / 255.0), clamp01(v[1] / 255.0), clamp01(v[2] / 255.0), clamp01(v[3])};
+	}
+	// "none", "transparent" and unknown names stay fully transparent
+	cachedCss = css;
+	cachedColor = c;
+	return cachedColor;
+}
+
+void RasterCanvas::blend(int x, int y, const Color& c, float coverage) {
+	float a = c.a * coverage;
+	if (a <= 0.0f) return;
+	uint8_t* p = &rgba[(static_cast<std::size_t>(y) * static_cast<std::size_t>(widthPx) + static_cast<std::size_t>(x)) * 4];
+	p[0] = static_cast<uint8_t>(p[0] + (c.r * 255.0f - p[0]) * a + 0.5f);
+	p[1] = static_cast<uint8_t>(p[1] + (c.g * 255.0f - p[1]) * a + 0.5f);
+	p[2] = static_cast<uint8_t>(p[2] + (c.b * 255.0f - p[2]) * a + 0.5f);
+	p[3] = static_cast<uint8_t>(p[3] + (255.0f - p[3]) * a + 0.5f);
+}
+
+void RasterCanvas::cover_segment(double x1, double y1, double x2, double y2, double hw, bool roundCap) {
+	if (mask.empty()) mask.assign(static_cast<std::size_t>(widthPx) * static_cast<std::size_t>(heightPx), 0.0f);
+	const double reach = hw + 1.0;
+	int by0 = clamp_pixel(std::floor(std::min(y1, y2) - reach), 0, heightPx);
+	int by1 = clamp_pixel(std::ceil(std::max(y1, y2) + reach), -1, heightPx - 1);
+	int bx0 = clamp_pixel(std::floor(std::min(x1, x2) - reach), 0, widthPx);
+	int bx1 = clamp_pixel(std::ceil(std::max(x1, x2) + reach), -1, widthPx - 1);
+	if (by0 > by1 || bx0 > bx1) return;
+
+	const double dx = x2 - x1, dy = y2 - y1;
+	const double len2 = dx * dx + dy * dy;
+	const double len = std::sqrt(len2);
+	if (len == 0.0 && !roundCap) return;
+
+	for (int py = by0; py <= by1; ++py) {
+		const double cy = py + 0.5;
+		// Scanline span: pixels within `reach` of the infinite line through the segment.
+		// Nearly horizontal segments, whose span would be wider than the box, use the box
+		int sx0 = bx0, sx1 = bx1;
+		if (std::abs(dy) * (bx1 - bx0 + 1) > reach * len) {
+			double xc = x1 + (cy - y1) * dx / dy;
+			double half = reach * len / std::abs(dy);
+			sx0 = clamp_pixel(std::floor(xc - half), bx0, bx1 + 1);
+			sx1 = clamp_pixel(std::ceil(xc + half), bx0 - 1, bx1);
+		}
+		float* row = &mask[static_cast<std::size_t>(py) * static_cast<std::size_t>(widthPx)];
+		for (int px = sx0; px <= sx1; ++px) {
+			const double cx = px + 0.5;
+			double t = len2 > 0.0 ? ((cx - x1) * dx + (cy - y1) * dy) / len2 : 0.0;
+			float cov;
+			if (roundCap) {
+				double tc = std::clamp(t, 0.0, 1.0);
+				double ex = cx - (x1 + tc * dx), ey = cy - (y1 + tc * dy);
+				cov = clamp01(hw + 0.5 - std::sqrt(ex * ex + ey * ey));
+			} else {
+				double perp = std::abs((cx - x1) * dy - (cy - y1) * dx) / len;
+				double s = t * len;
+				cov = clamp01(hw + 0.5 - perp) * clamp01(std::min(s, len - s) + 0.5);
+			}
+			if (cov > row[px]) row[px] = cov;
+		}
+	}
+	maskX0 = std::min(maskX0, bx0);
+	maskY0 = std::min(maskY0, by0);
+	maskX1 = std::max(maskX1, bx1);
+	maskY1 = std::max(maskY1, by1);
+}
+
+void RasterCanvas::composite_mask(const Color& c) {
+	for (int py = maskY0; py <= maskY1; ++py) {
+		float* row = &mask[static_cast<std::size_t>(py) * static_cast<std::size_t>(widthPx)];
+		for (int px = maskX0; px <= maskX1; ++px) {
+			if (row[px] > 0.0f) {
+				blend(px, py, c, row[px]);
+				row[px] = 0.0f;
+			}
+		}
+	}
+	maskX0 = widthPx;
+	maskY0 = heightPx;
+	maskX1 = -1;
+	maskY1 = -1;
+}
+
+void RasterCanvas::line(double x1, double y1, double x2, double y2, const std::string& stroke, double strokeWidth, const std::string& linecap) {
+	Color c = resolve(stroke);
+	if (c.a <= 0.0f) return;
+	cover_segment(x1 + offX, y1 + offY, x2 + offX, y2 + offY, strokeWidth * 0.5, linecap != "butt");
+	composite_mask(c);
+}
+
+void RasterCanvas::begin_polyline(const std::string& stroke, double strokeWidth) {
+	polyColor = resolve(stroke);
+	polyHalfWidth = strokeWidth * 0.5;
+	polyHasPoint = false;
+}
+
+void RasterCanvas::polyline_point(double x, double y) {
+	x += offX;
+	y += offY;
+	if (polyHasPoint && polyColor.a > 0.0f) cover_segment(polyLastX, polyLastY, x, y, polyHalfWidth, true);
+	polyLastX = x;
+	polyLastY = y;
+	polyHasPoint = true;
+}
+
+void RasterCanvas::end_polyline() {
+	if (maskX1 >= maskX0) composite_mask(polyColor);
+	polyHasPoint = false;
+}
+
+void RasterCanvas::circle(double cx, double cy, double r, const std::string& fill) {
+	fill_circle(cx, cy, r, resolve(fill));
+}
+
+void RasterCanvas::begin_markers(const std::string& fill, double r) {
+	markerColor = resolve(fill);
+	markerRadius = r;
+}
+
+void RasterCanvas::marker(double cx, double cy) {
+	fill_circle(cx, cy, markerRadius, markerColor);
+}
+
+void RasterCanvas::fill_circle(double cx, double cy, double r, const Color& c) {
+	if (c.a <= 0.0f || r <= 0.0) return;
+	cx += offX;
+	cy += offY;
+	int y0 = clamp_pixel(std::floor(cy - r - 1.0), 0, heightPx);
+	int y1 = clamp_pixel(std::ceil(cy + r + 1.0), -1, heightPx - 1);
+	int x0 = clamp_pixel(std::floor(cx - r - 1.0), 0, widthPx);
+	int x1 = clamp_pixel(std::ceil(cx + r + 1.0), -1, widthPx - 1);
+	for (int py = y0; py <= y1; ++py) {
+		double ey = py + 0.5 - cy;
+		for (int px = x0; px <= x1; ++px) {
+			double ex = px + 0.5 - cx;
+			float cov = clamp01(r + 0.5 - std::sqrt(ex * ex + ey * ey));
+			if (cov > 0.0f) blend(px, py, c, cov);
+		}
+	}
+}
+
+void RasterCanvas::rect(double x, double y, double w, double h, const std::string& stroke, double strokeWidth, const std::string& fill) {
+	x += offX;
+	y += offY;
+	Color fillColor = resolve(fill);
+	Color strokeColor = resolve(stroke);
+	const double hw = strokeWidth * 0.5;
+	const bool doFill = fillColor.a > 0.0f;
+	const bool doStroke = strokeColor.a > 0.0f && strokeWidth > 0.0;
+	const bool hollow = w > strokeWidth && h > strokeWidth;
+	int y0 = clamp_pixel(std::floor(y - hw), 0, heightPx);
+	int y1 = clamp_pixel(std::ceil(y + h + hw), -1, heightPx - 1);
+	int x0 = clamp_pixel(std::floor(x - hw), 0, widthPx);
+	int x1 = clamp_pixel(std::ceil(x + w + hw), -1, widthPx - 1);
+	if (x0 > x1 || y0 > y1) return;
+
+	// Box coverage is separable: per-column overlaps for the fill box and for the
+	// outer/inner boxes of the stroke (stroke is centred on the outline)
+	const std::size_t cols = static_cast<std::size_t>(x1 - x0 + 1);
+	std::vector<double> fillX(cols), outerX(cols), innerX(cols);
+	for (int px = x0; px <= x1; ++px) {
+		std::size_t i = static_cast<std::size_t>(px - x0);
+		fillX[i] = span_overlap(px, x, x + w);
+		outerX[i] = span_overlap(px, x - hw, x + w + hw);
+		innerX[i] = hollow ? span_overlap(px, x + hw, x + w - hw) : 0.0;
+	}
+	for (int py = y0; py <= y1; ++py) {
+		const double fillY = span_overlap(py, y, y + h);
+		const double outerY = span_overlap(py, y - hw, y + h + hw);
+		const double innerY = hollow ? span_overlap(py, y + hw, y + h - hw) : 0.0;
+		for (int px = x0; px <= x1; ++px) {
+			std::size_t i = static_cast<std::size_t>(px - x0);
+			if (doFill) {
+				float cov = clamp01(fillX[i] * fillY);
+				if (cov > 0.0f) blend(px, py, fillColor, cov);
+			}
+			if (doStroke) {
+				float cov = clamp01(outerX[i] * outerY - innerX[i] * innerY);
+				if (cov > 0.0f) blend(px, py, strokeColor, cov);
+			}
+		}
+	}
+}
+
+void RasterCanvas::text(double x, double y, const std::string& content, const std::string& fill, int fontSize, const std::string& anchor, double rotateDeg) {
+	const Color c = resolve(fill);
+	if (c.a <= 0.0f || content.empty() || fontSize <= 0) return;
+	x += offX;
+	y += offY;
+	// Glyph cell unit: 7 units of glyph height are ~0.7em, close to sans-serif cap height
+	const double u = fontSize / 10.0;
+	const double textW = (static_cast<double>(content.size()) * BitmapFont::kAdvance - 1) * u;
+	double left = x;
+	if (anchor == "middle") left -= textW * 0.5;
+	else if (anchor == "end") left -= textW;
+	const double top = y - BitmapFont::kGlyphHeight * u;
+
+	// Rotation about (x, y) like SVG rotate(deg x y); positive angles turn clockwise
+	const double rad = rotateDeg * 3.14159265358979323846 / 180.0;
+	const double cs = std::cos(rad), sn = std::sin(rad);
+	double bx0 = 1e300, by0 = 1e300, bx1 = -1e300, by1 = -1e300;
+	const double corners[4][2] = {{left, top}, {left + textW, top}, {left, y}, {left + textW, y}};
+	for (const auto& p : corners) {
+		double rx = x + (p[0] - x) * cs - (p[1] - y) * sn;
+		double ry = y + (p[0] - x) * sn + (p[1] - y) * cs;
+		bx0 = std::min(bx0, rx); bx1 = std::max(bx1, rx);
+		by0 = std::min(by0, ry); by1 = std::max(by1, ry);
+	}
+	int px0 = clamp_pixel(std::floor(bx0), 0, widthPx);
+	int px1 = clamp_pixel(std::ceil(bx1), -1, widthPx - 1);
+	int py0 = clamp_pixel(std::floor(by0), 0, heightPx);
+	int py1 = clamp_pixel(std::ceil(by1), -1, heightPx - 1);
+
+	// 4x4 supersampling of the glyph bitmaps in text space
+	const int ss = 4;
+	for (int py = py0; py <= py1; ++py) {
+		for (int px = px0; px <= px1; ++px) {
+			int hits = 0;
+			for (int sy = 0; sy < ss; ++sy) {
+				for (int sx = 0; sx < ss; ++sx) {
+					double qx = px + (sx + 0.5) / ss - x;
+					double qy = py + (sy + 0.5) / ss - y;
+					// Inverse rotation back into unrotated text space
+					double tx = x + qx * cs + qy * sn;
+					double ty = y - qx * sn + qy * cs;
+					double lx = (tx - left) / u;
+					double ly = (ty - top) / u;
+					if (lx < 0.0 || ly < 0.0 || ly >= BitmapFont::kGlyphHeight) continue;
+					std::size_t ci = static_cast<std::size_t>(lx / BitmapFont::kAdvance);
+					if (ci >= content.size()) continue;
+					int col = static_cast<int>(lx) - static_cast<int>(ci) * BitmapFont::kAdvance;
+					if (col >= BitmapFont::kGlyphWidth) continue;
+					const uint8_t* rows = BitmapFont::glyph(content[ci]);
+					if (rows[static_cast<int>(ly)] & (1u << (BitmapFont::kGlyphWidth - 1 - col))) ++hits;
+				}
+			}
+			if (hits > 0) blend(px, py, c, static_cast<float>(hits) / (ss * ss));
+		}
+	}
+}
+
+void RasterCanvas::begin_group_translate(double tx, double ty) {
+	groups.emplace_back(tx, ty);
+	offX += tx;
+	offY += ty;
+}
+
+void RasterCanvas::end_group() {
+	if (groups.empty()) return;
+	offX -= groups.back().first;
+	offY -= groups.back().second;
+	groups.pop_back();
+}
+
+} // namespace catplot
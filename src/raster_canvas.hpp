@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace catplot {
+
+// Software rasterizer with the same drawing primitives as SvgCanvas. Draws into
+// an 8-bit RGBA framebuffer using anti-aliased coverage: strokes are rasterized
+// scanline by scanline into a coverage mask (so overlapping polyline segments
+// blend once), fills and markers are blended with analytic pixel coverage.
+class RasterCanvas {
+public:
+	RasterCanvas(int widthPx, int heightPx);
+
+	void line(double x1, double y1, double x2, double y2, const std::string& stroke, double strokeWidth, const std::string& linecap = "round");
+
+	void begin_polyline(const std::string& stroke, double strokeWidth);
+	void polyline_point(double x, double y);
+	void end_polyline();
+
+	void circle(double cx, double cy, double r, const std::string& fill);
+
+	void begin_markers(const std::string& fill, double r);
+	void marker(double cx, double cy);
+	void end_markers() {}
+
+	void text(double x, double y, const std::string& content, const std::string& fill = "black", int fontSize = 12, const std::string& anchor = "start", double rotateDeg = 0.0);
+
+	void rect(double x, double y, double w, double h, const std::string& stroke, double strokeWidth, const std::string& fill = "none");
+
+	void begin_group_translate(double tx, double ty);
+	void end_group();
+
+	int width() const { return widthPx; }
+	int height() const { return heightPx; }
+	// RGBA8, rows top to bottom
+	const uint8_t* pixels() const { return rgba.data(); }
+
+private:
+	struct Color {
+		float r{0}, g{0}, b{0}, a{0};
+	};
+
+	const Color& resolve(const std::string& css);
+	void blend(int x, int y, const Color& c, float coverage);
+	void cover_segment(double x1, double y1, double x2, double y2, double halfWidth, bool roundCap);
+	void composite_mask(const Color& c);
+	void fill_circle(double cx, double cy, double r, const Color& c);
+
+	int widthPx;
+	int heightPx;
+	std::vector<uint8_t> rgba;
+
+	// Stroke coverage accumulated with max() and composited once per stroke
+	std::vector<float> mask;
+	int maskX0, maskY0, maskX1, maskY1;
+
+	// Current translation (sum of open groups)
+	double offX{0}, offY{0};
+	std::vector<std::pair<double, double>> groups;
+
+	// Polyline being streamed
+	Color polyColor;
+	double polyHalfWidth{0.5};
+	bool polyHasPoint{false};
+	double polyLastX{0}, polyLastY{0};
+
+	// Marker series being streamed
+	Color markerColor;
+	double markerRadius{0};
+
+	// Last parsed CSS color; primitives of one series repeat the same string
+	std::string cachedCss;
+	Color cachedColor;
+};
+
+} // namespace catplot
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "catplot/axes.hpp"
+#include <cstddef>
+#include <memory_resource>
+
+namespace catplot {
+
+// Where arenas created on the calling thread take their heap blocks from
+// (nullptr: new/delete). BatchRenderer workers point it at a per-thread pool so
+// the blocks are recycled from one figure to the next.
+inline std::pmr::memory_resource*& thread_arena_heap() {
+	thread_local std::pmr::memory_resource* heap = nullptr;
+	return heap;
+}
+
+// Sets thread_arena_heap() for its lifetime
+class ScopedArenaHeap {
+public:
+	explicit ScopedArenaHeap(std::pmr::memory_resource* heap) : previous(thread_arena_heap()) { thread_arena_heap() = heap; }
+	~ScopedArenaHeap() { thread_arena_heap() = previous; }
+
+	ScopedArenaHeap(const ScopedArenaHeap&) = delete;
+	ScopedArenaHeap& operator=(const ScopedArenaHeap&) = delete;
+
+private:
+	std::pmr::memory_resource* previous;
+};
+
+// Monotonic scratch memory for one render pass. Transient buffers allocate
+// from it through std::pmr containers; deallocation is a no-op and everything
+// is released in one shot when the arena goes out of scope. The first 16 KB
+// come from storage inside the arena itself, so small renders do not touch
+// the heap at all. Not thread-safe: one arena per rendering thread.
+class RenderArena final : public std::pmr::memory_resource {
+public:
+	RenderArena() : upstream(counts), pool(initial, sizeof(initial), &upstream) {}
+
+	RenderArena(const RenderArena&) = delete;
+	RenderArena& operator=(const RenderArena&) = delete;
+
+	const ArenaStats& stats() const { return counts; }
+
+private:
+	// Heap blocks the arena grows by, counted
+	class Upstream final : public std::pmr::memory_resource {
+	public:
+		explicit Upstream(ArenaStats& stats)
+			: counts(stats), heap(thread_arena_heap() ? thread_arena_heap() : std::pmr::new_delete_resource()) {}
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			++counts.blocks;
+			return heap->allocate(bytes, alignment);
+		}
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+			heap->deallocate(p, bytes, alignment);
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		ArenaStats& counts;
+		std::pmr::memory_resource* heap;
+	};
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		++counts.allocations;
+		counts.bytes += bytes;
+		return pool.allocate(bytes, alignment);
+	}
+	void do_deallocate(void*, std::size_t, std::size_t) override {}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	ArenaStats counts;
+	alignas(std::max_align_t) unsigned char initial[16 * 1024];
+	Upstream upstream;
+	std::pmr::monotonic_buffer_resource pool;
+};
+
+} // namespace catplot
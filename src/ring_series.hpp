@@ -0,0 +1,69 @@
+#pragma once
+
+#include "series_span.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace catplot {
+
+// Fixed-capacity (x, y) history for bounded live plots. Once full, push()
+// overwrites the oldest samples in place; memory never grows past capacity.
+class RingSeries {
+public:
+	explicit RingSeries(std::size_t capacity)
+		: xs(capacity), ys(capacity) {
+		if (capacity == 0) throw std::invalid_argument("Ring series capacity must be positive");
+	}
+
+	void push(const double* x, const double* y, std::size_t n) {
+		const std::size_t cap = xs.size();
+		if (n >= cap) {
+			// Only the newest `cap` samples survive
+			std::memcpy(xs.data(), x + (n - cap), cap * sizeof(double));
+			std::memcpy(ys.data(), y + (n - cap), cap * sizeof(double));
+			head = 0;
+			count = cap;
+			return;
+		}
+		std::size_t tail = (head + count) % cap; // next write position
+		std::size_t first = std::min(n, cap - tail);
+		std::memcpy(xs.data() + tail, x, first * sizeof(double));
+		std::memcpy(ys.data() + tail, y, first * sizeof(double));
+		std::memcpy(xs.data(), x + first, (n - first) * sizeof(double));
+		std::memcpy(ys.data(), y + first, (n - first) * sizeof(double));
+		std::size_t total = count + n;
+		if (total > cap) {
+			head = (head + (total - cap)) % cap;
+			total = cap;
+		}
+		count = total;
+	}
+
+	std::size_t size() const { return count; }
+	std::size_t capacity() const { return xs.size(); }
+
+	// Samples oldest first, as one or two contiguous segments
+	SeriesSpan spans() const {
+		SeriesSpan s;
+		const std::size_t cap = xs.size();
+		const std::size_t first = std::min(count, cap - head);
+		s.x[0] = SampleColumn::of(xs.data() + head);
+		s.y[0] = SampleColumn::of(ys.data() + head);
+		s.n[0] = first;
+		s.x[1] = SampleColumn::of(xs.data());
+		s.y[1] = SampleColumn::of(ys.data());
+		s.n[1] = count - first;
+		return s;
+	}
+
+private:
+	std::vector<double> xs;
+	std::vector<double> ys;
+	std::size_t head{0};  // index of the oldest sample
+	std::size_t count{0};
+};
+
+} // namespace catplot
@@ -0,0 +1,141 @@
+#include "scatter_dedup.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace catplot {
+
+namespace {
+
+// Key layout for decimal keys: mantissa in bits 0-49, biased decimal exponent in
+// bits 50-60, sign in bit 61. Exact keys are the bits of a finite double. Neither
+// form can equal kEmptySlot, which is a NaN bit pattern.
+constexpr int kMantissaBits = 50;
+constexpr int kExponentBias = 1024;
+constexpr uint64_t kEmptySlot = ~0ull;
+
+struct PointKey {
+	uint64_t x, y;
+	bool operator==(const PointKey& o) const { return x == o.x && y == o.y; }
+};
+
+// Open-addressing set of point keys; kEmptySlot in x marks empty slots
+class KeySet {
+public:
+	explicit KeySet(std::pmr::memory_resource* scratch) : slots(1024, PointKey{kEmptySlot, 0}, scratch) {}
+
+	// True when the key was not present before
+	bool insert(const PointKey& key) {
+		if ((used + 1) * 2 > slots.size()) grow();
+		return place(key);
+	}
+
+private:
+	bool place(const PointKey& key) {
+		const std::size_t mask = slots.size() - 1;
+		for (std::size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+			if (slots[i] == key) return false;
+			if (slots[i].x == kEmptySlot) {
+				slots[i] = key;
+				++used;
+				return true;
+			}
+		}
+	}
+
+	void grow() {
+		std::pmr::vector<PointKey> old(slots.size() * 2, PointKey{kEmptySlot, 0}, slots.get_allocator());
+		old.swap(slots);
+		used = 0;
+		for (const PointKey& key : old) if (key.x != kEmptySlot) place(key);
+	}
+
+	static std::size_t hash(const PointKey& key) {
+		const uint64_t h = (key.x * 0x9e3779b97f4a7c15ull) ^ (key.y * 0xc2b2ae3d27d4eb4full);
+		return static_cast<std::size_t>(h >> 20);
+	}
+
+	std::pmr::vector<PointKey> slots;
+	std::size_t used{0};
+};
+
+// CoordinateKey behind a direct-mapped memo indexed by the bits of the value.
+// Dense scatter data maps to the same pixel coordinates over and over, and
+// formatting is the expensive part of a key.
+class MemoizedKey {
+public:
+	MemoizedKey(int precision, std::pmr::memory_resource* scratch)
+		: key(precision), memo(std::size_t{1} << kMemoBits, Entry{kEmptySlot, 0}, scratch) {}
+
+	uint64_t operator()(double v) {
+		uint64_t bits;
+		std::memcpy(&bits, &v, sizeof bits);
+		Entry& e = memo[static_cast<std::size_t>((bits * 0x9e3779b97f4a7c15ull) >> (64 - kMemoBits))];
+		if (e.bits != bits) e = Entry{bits, key(v)};
+		return e.key;
+	}
+
+private:
+	static constexpr int kMemoBits = 12;
+	struct Entry {
+		uint64_t bits, key;
+	};
+	CoordinateKey key;
+	std::pmr::vector<Entry> memo;
+};
+
+} // namespace
+
+uint64_t CoordinateKey::operator()(double v) const {
+	if (exact) {
+		uint64_t bits;
+		std::memcpy(&bits, &v, sizeof bits);
+		return bits;
+	}
+	// Read back the digits and exponent of the formatted text. The same value is
+	// always formatted the same way, so this is a one-to-one map of the text.
+	char text[NumberFormatter::kMaxChars];
+	const std::size_t len = formatter.format(v, text);
+	std::size_t i = 0;
+	const bool negative = len > 0 && text[0] == '-';
+	if (negative) ++i;
+	uint64_t mantissa = 0;
+	int exponent = 0;
+	bool fraction = false;
+	for (; i < len && text[i] != 'e'; ++i) {
+		if (text[i] == '.') {
+			fraction = true;
+			continue;
+		}
+		mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+		if (fraction) --exponent;
+	}
+	if (i < len) {
+		// "e+NN" or "e-NN"
+		const bool negativeExp = text[i + 1] == '-';
+		int e = 0;
+		for (i += 2; i < len; ++i) e = e * 10 + (text[i] - '0');
+		exponent += negativeExp ? -e : e;
+	}
+	return mantissa | static_cast<uint64_t>(exponent + kExponentBias) << kMantissaBits
+		| static_cast<uint64_t>(negative) << (kMantissaBits + 11);
+}
+
+std::pmr::vector<std::size_t> dedup_points(const SampleColumn& xs, const SampleColumn& ys, std::size_t n,
+	const AxisAffine& mx, const AxisAffine& my, int precision, const DataBounds* view,
+	std::pmr::memory_resource* scratch) {
+	MemoizedKey keyX(precision, scratch), keyY(precision, scratch);
+	std::pmr::vector<std::size_t> keep(scratch);
+	KeySet seen(scratch);
+	for_each_block(xs, ys, n, [&](std::size_t base, const double* px, const double* py, std::size_t count) {
+		for (std::size_t k = 0; k < count; ++k) {
+			const double x = px[k], y = py[k];
+			if (view && !(x >= view->xmin && x <= view->xmax && y >= view->ymin && y <= view->ymax)) continue;
+			// Same expressions the backend hands to the canvas
+			const double X = mx.apply(x), Y = my.apply(y);
+			if (!std::isfinite(X) || !std::isfinite(Y) || seen.insert(PointKey{keyX(X), keyY(Y)})) keep.push_back(base + k);
+		}
+	});
+	return keep;
+}
+
+} // namespace catplot
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "number_format.hpp"
+#include "series_span.hpp"
+#include "simd_affine.hpp"
+#include "catplot/axes.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace catplot {
+
+// Identity of a pixel coordinate as a canvas emits it. For precision up to
+// kMaxDecimalDigits the key is the decimal value NumberFormatter writes, so two
+// coordinates share a key exactly when they print the same; above that the key
+// is the double itself. Non-finite values have no key and are never merged.
+class CoordinateKey {
+public:
+	// Significant digits whose decimal mantissa still fits the key
+	static constexpr int kMaxDecimalDigits = 15;
+
+	explicit CoordinateKey(int precision) : formatter(precision), exact(formatter.precision() > kMaxDecimalDigits) {}
+
+	// Key of the finite value v
+	uint64_t operator()(double v) const;
+
+private:
+	NumberFormatter formatter;
+	bool exact;
+};
+
+// Indices of the points to draw, in input order: the first point of every
+// distinct emitted marker position (see CoordinateKey) plus all points with a
+// non-finite pixel coordinate. `precision` is the canvas's number precision;
+// canvases that keep full doubles pass NumberFormatter::kMaxPrecision. With a
+// `view`, points whose data position lies outside it are dropped before they
+// are looked up, so they never hide a visible point. Memory grows with the
+// number of distinct positions, not with n; all of it comes from `scratch`.
+// The columns are read in place, in any element type.
+std::pmr::vector<std::size_t> dedup_points(const SampleColumn& xs, const SampleColumn& ys, std::size_t n,
+	const AxisAffine& mx, const AxisAffine& my, int precision, const DataBounds* view,
+	std::pmr::memory_resource* scratch);
+
+} // namespace catplot
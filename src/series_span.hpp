@@ -0,0 +1,144 @@
+#pragma once
+
+#include "catplot/series_data.hpp"
+#include "simd_affine.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace catplot {
+
+// Non-owning view of one column of samples in any SeriesData element type and
+// stride. Values are converted to double only as they are read.
+struct SampleColumn {
+	const void* data{nullptr};
+	ElementType type{ElementType::Float64};
+	std::ptrdiff_t stride{1};
+
+	static SampleColumn of(const double* values) { return {values, ElementType::Float64, 1}; }
+	static SampleColumn of(const SeriesData& d) { return {d.data(), d.type(), d.stride()}; }
+
+	// Contiguous doubles can be handed to the SIMD kernels as they are
+	const double* contiguous_f64() const {
+		return type == ElementType::Float64 && stride == 1 ? static_cast<const double*>(data) : nullptr;
+	}
+
+	// Invoke f(const T* base) with the concrete element type
+	template<typename F>
+	decltype(auto) visit(F&& f) const {
+		switch (type) {
+		case ElementType::Float32: return f(static_cast<const float*>(data));
+		case ElementType::Int64: return f(static_cast<const int64_t*>(data));
+		case ElementType::Int32: return f(static_cast<const int32_t*>(data));
+		case ElementType::Int16: return f(static_cast<const int16_t*>(data));
+		case ElementType::Int8: return f(static_cast<const int8_t*>(data));
+		case ElementType::UInt64: return f(static_cast<const uint64_t*>(data));
+		case ElementType::UInt32: return f(static_cast<const uint32_t*>(data));
+		case ElementType::UInt16: return f(static_cast<const uint16_t*>(data));
+		case ElementType::UInt8: return f(static_cast<const uint8_t*>(data));
+		case ElementType::Float64:
+		default: return f(static_cast<const double*>(data));
+		}
+	}
+
+	double at(std::size_t k) const {
+		const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(k) * stride;
+		return visit([offset](const auto* base) { return static_cast<double>(base[offset]); });
+	}
+
+	// Samples [first, first + count) as doubles into out
+	void gather(std::size_t first, std::size_t count, double* out) const {
+		visit([&](const auto* base) {
+			const auto* p = base + static_cast<std::ptrdiff_t>(first) * stride;
+			for (std::size_t i = 0; i < count; ++i) out[i] = static_cast<double>(p[static_cast<std::ptrdiff_t>(i) * stride]);
+		});
+	}
+
+	// m.apply() of samples [first, first + count) into out; contiguous double
+	// and float columns go straight through the SIMD kernels
+	void map(std::size_t first, std::size_t count, const AxisAffine& m, double* out) const {
+		if (stride == 1 && type == ElementType::Float64) {
+			affine_f64(static_cast<const double*>(data) + first, count, m, out);
+		} else if (stride == 1 && type == ElementType::Float32) {
+			affine_f32(static_cast<const float*>(data) + first, count, m, out);
+		} else {
+			gather(first, count, out);
+			affine_f64(out, count, m, out);
+		}
+	}
+
+	SampleColumn offset_by(std::size_t k) const {
+		SampleColumn c = *this;
+		c.data = visit([&](const auto* base) -> const void* { return base + static_cast<std::ptrdiff_t>(k) * stride; });
+		return c;
+	}
+};
+
+// Samples of one series as read by the renderer, in up to two segments (a ring
+// buffer that wrapped around yields two; everything else one). Sample k is the
+// k-th of segment 0 followed by segment 1. The columns point at storage owned
+// by the Axes, so building a span copies no sample data.
+struct SeriesSpan {
+	SampleColumn x[2];
+	SampleColumn y[2];
+	std::size_t n[2]{0, 0};
+
+	static SeriesSpan of(const double* xs, const double* ys, std::size_t count) {
+		return of(SampleColumn::of(xs), SampleColumn::of(ys), count);
+	}
+	static SeriesSpan of(const SeriesData& xs, const SeriesData& ys) {
+		return of(SampleColumn::of(xs), SampleColumn::of(ys), std::min(xs.size(), ys.size()));
+	}
+	static SeriesSpan of(const SampleColumn& xs, const SampleColumn& ys, std::size_t count) {
+		SeriesSpan s;
+		s.x[0] = xs;
+		s.y[0] = ys;
+		s.n[0] = count;
+		return s;
+	}
+
+	std::size_t size() const { return n[0] + n[1]; }
+	double x_at(std::size_t k) const { return k < n[0] ? x[0].at(k) : x[1].at(k - n[0]); }
+	double y_at(std::size_t k) const { return k < n[0] ? y[0].at(k) : y[1].at(k - n[0]); }
+
+	// Call f(x, y, count, firstIndex) for each non-empty segment in order
+	template<typename F>
+	void for_each_segment(F&& f) const {
+		if (n[0] > 0) f(x[0], y[0], n[0], std::size_t{0});
+		if (n[1] > 0) f(x[1], y[1], n[1], n[0]);
+	}
+};
+
+// Mapped samples are produced in blocks of this many points
+constexpr std::size_t kMapBlock = 512;
+
+// f(k, X, Y) for every sample of one segment, with pixel coordinates from the
+// SIMD affine kernels; only a block of mapped values is ever held
+template<typename F>
+void for_each_mapped(const SampleColumn& xs, const SampleColumn& ys, std::size_t count, const AxisAffine& mx, const AxisAffine& my, F&& f) {
+	double X[kMapBlock], Y[kMapBlock];
+	for (std::size_t base = 0; base < count; base += kMapBlock) {
+		const std::size_t m = std::min(kMapBlock, count - base);
+		xs.map(base, m, mx, X);
+		ys.map(base, m, my, Y);
+		for (std::size_t k = 0; k < m; ++k) f(base + k, X[k], Y[k]);
+	}
+}
+
+// f(first, xs, ys, count) for consecutive blocks of one segment as doubles in
+// data units; contiguous double columns are passed through without a copy
+template<typename F>
+void for_each_block(const SampleColumn& xs, const SampleColumn& ys, std::size_t count, F&& f) {
+	const double* cx = xs.contiguous_f64();
+	const double* cy = ys.contiguous_f64();
+	double bx[kMapBlock], by[kMapBlock];
+	for (std::size_t base = 0; base < count; base += kMapBlock) {
+		const std::size_t m = std::min(kMapBlock, count - base);
+		const double* px = cx ? cx + base : bx;
+		const double* py = cy ? cy + base : by;
+		if (!cx) xs.gather(base, m, bx);
+		if (!cy) ys.gather(base, m, by);
+		f(base, px, py, m);
+	}
+}
+
+} // namespace catplot
@@ -0,0 +1,97 @@
+#include "simd_affine.hpp"
+#include "cpu_dispatch.hpp"
+
+namespace catplot {
+
+namespace {
+
+// Separate sub, mul and add (no FMA) so every kernel rounds like apply()
+
+template<typename T>
+inline void affine_tail(const T* in, std::size_t i, std::size_t n, const AxisAffine& m, double* out) {
+	for (; i < n; ++i) out[i] = m.apply(static_cast<double>(in[i]));
+}
+
+#if CATPLOT_HAVE_SSE2
+inline __m128d affine_sse2(__m128d v, __m128d origin, __m128d scale, __m128d offset) {
+	return _mm_add_pd(offset, _mm_mul_pd(_mm_sub_pd(v, origin), scale));
+}
+
+void affine_f64_sse2(const double* in, std::size_t n, const AxisAffine& m, double* out) {
+	const __m128d o = _mm_set1_pd(m.origin), s = _mm_set1_pd(m.scale), f = _mm_set1_pd(m.offset);
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128d a = _mm_loadu_pd(in + i);
+		__m128d b = _mm_loadu_pd(in + i + 2);
+		_mm_storeu_pd(out + i, affine_sse2(a, o, s, f));
+		_mm_storeu_pd(out + i + 2, affine_sse2(b, o, s, f));
+	}
+	affine_tail(in, i, n, m, out);
+}
+
+void affine_f32_sse2(const float* in, std::size_t n, const AxisAffine& m, double* out) {
+	const __m128d o = _mm_set1_pd(m.origin), s = _mm_set1_pd(m.scale), f = _mm_set1_pd(m.offset);
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128 v = _mm_loadu_ps(in + i);
+		_mm_storeu_pd(out + i, affine_sse2(_mm_cvtps_pd(v), o, s, f));
+		_mm_storeu_pd(out + i + 2, affine_sse2(_mm_cvtps_pd(_mm_movehl_ps(v, v)), o, s, f));
+	}
+	affine_tail(in, i, n, m, out);
+}
+#endif
+
+#if CATPLOT_HAVE_AVX2
+CATPLOT_TARGET_AVX2
+void affine_f64_avx2(const double* in, std::size_t n, const AxisAffine& m, double* out) {
+	const __m256d o = _mm256_set1_pd(m.origin), s = _mm256_set1_pd(m.scale), f = _mm256_set1_pd(m.offset);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256d a = _mm256_loadu_pd(in + i);
+		__m256d b = _mm256_loadu_pd(in + i + 4);
+		_mm256_storeu_pd(out + i, _mm256_add_pd(f, _mm256_mul_pd(_mm256_sub_pd(a, o), s)));
+		_mm256_storeu_pd(out + i + 4, _mm256_add_pd(f, _mm256_mul_pd(_mm256_sub_pd(b, o), s)));
+	}
+	affine_tail(in, i, n, m, out);
+}
+
+CATPLOT_TARGET_AVX2
+void affine_f32_avx2(const float* in, std::size_t n, const AxisAffine& m, double* out) {
+	const __m256d o = _mm256_set1_pd(m.origin), s = _mm256_set1_pd(m.scale), f = _mm256_set1_pd(m.offset);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256d a = _mm256_cvtps_pd(_mm_loadu_ps(in + i));
+		__m256d b = _mm256_cvtps_pd(_mm_loadu_ps(in + i + 4));
+		_mm256_storeu_pd(out + i, _mm256_add_pd(f, _mm256_mul_pd(_mm256_sub_pd(a, o), s)));
+		_mm256_storeu_pd(out + i + 4, _mm256_add_pd(f, _mm256_mul_pd(_mm256_sub_pd(b, o), s)));
+	}
+	affine_tail(in, i, n, m, out);
+}
+#endif
+
+using AffineF64 = void (*)(const double*, std::size_t, const AxisAffine&, double*);
+using AffineF32 = void (*)(const float*, std::size_t, const AxisAffine&, double*);
+
+} // namespace
+
+void affine_f64_scalar(const double* in, std::size_t n, const AxisAffine& m, double* out) {
+	affine_tail(in, 0, n, m, out);
+}
+
+void affine_f32_scalar(const float* in, std::size_t n, const AxisAffine& m, double* out) {
+	affine_tail(in, 0, n, m, out);
+}
+
+void affine_f64(const double* in, std::size_t n, const AxisAffine& m, double* out) {
+	static const AffineF64 kernel = select_kernel<AffineF64>(
+		CATPLOT_AVX2_KERNEL(affine_f64_avx2), CATPLOT_SSE2_KERNEL(affine_f64_sse2), affine_f64_scalar);
+	kernel(in, n, m, out);
+}
+
+void affine_f32(const float* in, std::size_t n, const AxisAffine& m, double* out) {
+	static const AffineF32 kernel = select_kernel<AffineF32>(
+		CATPLOT_AVX2_KERNEL(affine_f32_avx2), CATPLOT_SSE2_KERNEL(affine_f32_sse2), affine_f32_scalar);
+	kernel(in, n, m, out);
+}
+
+} // namespace catplot
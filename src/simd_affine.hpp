@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace catplot {
+
+// Affine data-to-pixel map of one axis: pixel = offset + (v - origin) * scale
+struct AxisAffine {
+	double origin;
+	double scale;
+	double offset;
+
+	double apply(double v) const { return offset + (v - origin) * scale; }
+};
+
+// Map taking [vmin, vmax] onto [pxFrom, pxTo] (pxTo < pxFrom flips the axis, as
+// for y). An empty range maps everything to the middle of the pixel span.
+inline AxisAffine axis_affine(double vmin, double vmax, double pxFrom, double pxTo) {
+	if (vmax == vmin) return {vmin, 0.0, (pxFrom + pxTo) * 0.5};
+	return {vmin, (pxTo - pxFrom) / (vmax - vmin), pxFrom};
+}
+
+// out[i] = m.apply(in[i]) for n contiguous values; `out` may alias a double
+// input. Uses AVX2 when the CPU supports it, SSE2 on x86-64, scalar code
+// elsewhere; the kernel is chosen once at first use. Results are bit-identical
+// to AxisAffine::apply().
+void affine_f64(const double* in, std::size_t n, const AxisAffine& m, double* out);
+void affine_f32(const float* in, std::size_t n, const AxisAffine& m, double* out);
+
+// Portable reference implementations
+void affine_f64_scalar(const double* in, std::size_t n, const AxisAffine& m, double* out);
+void affine_f32_scalar(const float* in, std::size_t n, const AxisAffine& m, double* out);
+
+} // namespace catplot
@@ -0,0 +1,96 @@
+#include "simd_minmax.hpp"
+#include "cpu_dispatch.hpp"
+#include <limits>
+
+namespace catplot {
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// Comparisons with NaN are false, so NaN samples never replace the running values
+inline void scalar_tail(const double* p, std::size_t n, double& mn, double& mx) {
+	for (std::size_t i = 0; i < n; ++i) {
+		if (p[i] < mn) mn = p[i];
+		if (p[i] > mx) mx = p[i];
+	}
+}
+
+#if CATPLOT_HAVE_SSE2
+// min/max_pd return their second operand when either is NaN, so the
+// accumulator is always passed second
+bool minmax_sse2(const double* p, std::size_t n, double& mn, double& mx) {
+	__m128d mn0 = _mm_set1_pd(kInf), mn1 = mn0;
+	__m128d mx0 = _mm_set1_pd(-kInf), mx1 = mx0;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128d a = _mm_loadu_pd(p + i);
+		__m128d b = _mm_loadu_pd(p + i + 2);
+		mn0 = _mm_min_pd(a, mn0);
+		mn1 = _mm_min_pd(b, mn1);
+		mx0 = _mm_max_pd(a, mx0);
+		mx1 = _mm_max_pd(b, mx1);
+	}
+	double lo[2], hi[2];
+	_mm_storeu_pd(lo, _mm_min_pd(mn0, mn1));
+	_mm_storeu_pd(hi, _mm_max_pd(mx0, mx1));
+	double rmn = lo[0] < lo[1] ? lo[0] : lo[1];
+	double rmx = hi[0] > hi[1] ? hi[0] : hi[1];
+	scalar_tail(p + i, n - i, rmn, rmx);
+	if (!(rmn <= rmx)) return false;
+	mn = rmn;
+	mx = rmx;
+	return true;
+}
+#endif
+
+#if CATPLOT_HAVE_AVX2
+CATPLOT_TARGET_AVX2
+bool minmax_avx2(const double* p, std::size_t n, double& mn, double& mx) {
+	__m256d mn0 = _mm256_set1_pd(kInf), mn1 = mn0;
+	__m256d mx0 = _mm256_set1_pd(-kInf), mx1 = mx0;
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256d a = _mm256_loadu_pd(p + i);
+		__m256d b = _mm256_loadu_pd(p + i + 4);
+		mn0 = _mm256_min_pd(a, mn0);
+		mn1 = _mm256_min_pd(b, mn1);
+		mx0 = _mm256_max_pd(a, mx0);
+		mx1 = _mm256_max_pd(b, mx1);
+	}
+	double lo[4], hi[4];
+	_mm256_storeu_pd(lo, _mm256_min_pd(mn0, mn1));
+	_mm256_storeu_pd(hi, _mm256_max_pd(mx0, mx1));
+	double rmn = kInf, rmx = -kInf;
+	for (int k = 0; k < 4; ++k) {
+		if (lo[k] < rmn) rmn = lo[k];
+		if (hi[k] > rmx) rmx = hi[k];
+	}
+	scalar_tail(p + i, n - i, rmn, rmx);
+	if (!(rmn <= rmx)) return false;
+	mn = rmn;
+	mx = rmx;
+	return true;
+}
+#endif
+
+using MinMaxKernel = bool (*)(const double*, std::size_t, double&, double&);
+
+} // namespace
+
+bool minmax_f64_scalar(const double* data, std::size_t n, double& mn, double& mx) {
+	double rmn = kInf, rmx = -kInf;
+	scalar_tail(data, n, rmn, rmx);
+	if (!(rmn <= rmx)) return false;
+	mn = rmn;
+	mx = rmx;
+	return true;
+}
+
+bool minmax_f64(const double* data, std::size_t n, double& mn, double& mx) {
+	static const MinMaxKernel kernel = select_kernel<MinMaxKernel>(
+		CATPLOT_AVX2_KERNEL(minmax_avx2), CATPLOT_SSE2_KERNEL(minmax_sse2), minmax_f64_scalar);
+	return kernel(data, n, mn, mx);
+}
+
+} // namespace catplot
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+namespace catplot {
+
+// Minimum and maximum of `n` contiguous doubles in one pass. NaN samples are
+// ignored; returns false (leaving mn/mx untouched) when there is no other value.
+// Uses AVX2 when the CPU supports it, SSE2 on x86-64, scalar code elsewhere;
+// the kernel is chosen once at first use.
+bool minmax_f64(const double* data, std::size_t n, double& mn, double& mx);
+
+// Portable reference implementation with the same semantics
+bool minmax_f64_scalar(const double* data, std::size_t n, double& mn, double& mx);
+
+} // namespace catplot
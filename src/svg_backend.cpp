@@ -1,40 +1,21 @@
 #include "svg_backend.hpp"
+#include "raster_canvas.hpp"
+#include "display_list.hpp"
+#include "counting_canvas.hpp"
+#include "density.hpp"
+#include "scatter_dedup.hpp"
+#include "simd_affine.hpp"
+#include "catplot/downsample.hpp"
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <sstream>
-#include <tuple>
+#include <type_traits>
 
 namespace catplot {
 
-static std::tuple<double, double, double, double> compute_data_bounds(
-	const std::vector<std::pair<std::vector<double>, std::vector<double>>>& lineXY,
-	const std::vector<std::pair<std::vector<double>, std::vector<double>>>& scatterXY) {
-	bool has = false;
-	double xmin=0, xmax=0, ymin=0, ymax=0;
-	auto consider = [&](const std::vector<double>& xs, const std::vector<double>& ys) {
-		for (size_t i = 0; i < xs.size() && i < ys.size(); ++i) {
-			double x = xs[i], y = ys[i];
-			if (!has) { xmin = xmax = x; ymin = ymax = y; has = true; }
-			xmin = std::min(xmin, x); xmax = std::max(xmax, x);
-			ymin = std::min(ymin, y); ymax = std::max(ymax, y);
-		}
-	};
-	for (const auto& p : lineXY) consider(p.first, p.second);
-	for (const auto& p : scatterXY) consider(p.first, p.second);
-	if (!has) { xmin = 0; xmax = 1; ymin = 0; ymax = 1; }
-	// expand by 5%
-	auto expand = [](double& vmin, double& vmax) {
-		double range = (vmax - vmin);
-		if (range == 0.0) { vmin -= 0.5; vmax += 0.5; return; }
-		double pad = range * 0.05;
-		vmin -= pad; vmax += pad;
-	};
-	expand(xmin, xmax);
-	expand(ymin, ymax);
-	return {xmin, xmax, ymin, ymax};
-}
-
-static std::vector<double> nice_ticks(double vmin, double vmax, int target) {
-	std::vector<double> ticks;
+static std::pmr::vector<double> nice_ticks(double vmin, double vmax, int target, std::pmr::memory_resource* scratch) {
+	std::pmr::vector<double> ticks(scratch);
 	if (vmax < vmin) std::swap(vmax, vmin);
 	double range = vmax - vmin;
 	if (range <= 0) range = std::abs(vmin) > 1e-12 ? std::abs(vmin) : 1.0;
@@ -64,50 +45,274 @@ static std::string fmt_num(double v) {
 	return s;
 }
 
-static double map_x(double x, double xmin, double xmax, double left, double right) {
-	if (xmax == xmin) return (left + right) * 0.5;
-	double t = (x - xmin) / (xmax - xmin);
-	return left + t * (right - left);
+// SVG body of one series from its fragment cache. The cached text is reused when
+// the key (axis mapping, precision, marker radius) is unchanged, and only the
+// samples added since the last render are formatted with emit(text, k).
+template<typename Emit>
+static const std::string& refresh_fragment(SeriesFragmentCache& cache, const std::array<double, 10>& key, size_t n, Emit&& emit) {
+	if (!cache.valid || cache.key != key || cache.points > n) {
+		cache.text.clear();
+		cache.points = 0;
+		cache.key = key;
+		cache.valid = true;
+	}
+	for (size_t k = cache.points; k < n; ++k) emit(cache.text, k);
+	cache.points = n;
+	return cache.text;
+}
+
+// Significant digits the canvas writes coordinates with; the other canvases keep
+// full doubles
+template<typename CanvasT>
+static int emitted_precision(const CanvasT& canvas) {
+	if constexpr (std::is_same_v<CanvasT, SvgCanvas>) return canvas.precision();
+	else return NumberFormatter::kMaxPrecision;
+}
+
+// M4 level-of-detail reduction over mapped (pixel) coordinates. Consecutive
+// samples falling into the same pixel column are reduced to the first, the
+// minimum-Y, the maximum-Y and the last sample of that run, emitted in input
+// order. Every pixel the full polyline would touch is still covered, while the
+// vertex count is bounded by ~4x the number of columns for sorted x.
+class MinMaxDecimator {
+public:
+	template<typename CanvasT>
+	void add(size_t index, double X, double Y, CanvasT& canvas) {
+		// NaN, infinite or out-of-range X has no column: pass it through undecimated
+		if (!(std::abs(X) < 9.0e18)) {
+			flush(canvas);
+			canvas.polyline_point(X, Y);
+			return;
+		}
+		long long column = static_cast<long long>(std::floor(X));
+		if (active && column != currentColumn) flush(canvas);
+		if (!active) {
+			active = true;
+			currentColumn = column;
+			first = minP = maxP = last = Sample{index, X, Y};
+			return;
+		}
+		if (Y < minP.Y) minP = Sample{index, X, Y};
+		if (Y > maxP.Y) maxP = Sample{index, X, Y};
+		last = Sample{index, X, Y};
+	}
+
+	template<typename CanvasT>
+	void flush(CanvasT& canvas) {
+		if (!active) return;
+		const Sample* mid[2] = {&minP, &maxP};
+		if (maxP.index < minP.index) std::swap(mid[0], mid[1]);
+		size_t emitted = first.index;
+		canvas.polyline_point(first.X, first.Y);
+		for (const Sample* p : mid) {
+			if (p->index != emitted) { canvas.polyline_point(p->X, p->Y); emitted = p->index; }
+		}
+		if (last.index != emitted) canvas.polyline_point(last.X, last.Y);
+		active = false;
+	}
+
+private:
+	struct Sample {
+		size_t index;
+		double X;
+		double Y;
+	};
+	bool active{false};
+	long long currentColumn{0};
+	Sample first{}, minP{}, maxP{}, last{};
+};
+
+// Liang-Barsky: parameter range [t0, t1] of the segment (x0,y0)+t*(dx,dy),
+// t in [0, 1], inside the box; false when it misses the box entirely
+static bool clip_segment(double x0, double y0, double dx, double dy,
+	double xmin, double ymin, double xmax, double ymax, double& t0, double& t1) {
+	const double p[4] = {-dx, dx, -dy, dy};
+	const double q[4] = {x0 - xmin, xmax - x0, y0 - ymin, ymax - y0};
+	t0 = 0.0;
+	t1 = 1.0;
+	for (int k = 0; k < 4; ++k) {
+		if (p[k] == 0.0) {
+			if (q[k] < 0.0) return false; // parallel to and outside this edge
+			continue;
+		}
+		const double r = q[k] / p[k];
+		if (p[k] < 0.0) {
+			if (r > t1) return false;
+			t0 = std::max(t0, r);
+		} else {
+			if (r < t0) return false;
+			t1 = std::min(t1, r);
+		}
+	}
+	return true;
+}
+
+// Takes polyline_point() calls in place of the canvas and forwards only the
+// parts inside the plot box. Every visible piece becomes its own polyline, so
+// nothing is drawn over the margins; non-finite vertices also end a piece.
+template<typename CanvasT>
+class PolylineClipper {
+public:
+	PolylineClipper(CanvasT& target, std::string strokeCss, double strokeWidth, double boxLeft, double boxTop, double boxRight, double boxBottom)
+		: canvas(target), stroke(std::move(strokeCss)), width(strokeWidth), left(boxLeft), top(boxTop), right(boxRight), bottom(boxBottom) {}
+
+	void polyline_point(double X, double Y) {
+		if (!std::isfinite(X) || !std::isfinite(Y)) {
+			finish();
+			hasPrev = false;
+			return;
+		}
+		if (!hasPrev) {
+			hasPrev = true;
+			prevX = X;
+			prevY = Y;
+			if (X >= left && X <= right && Y >= top && Y <= bottom) emit(X, Y);
+			return;
+		}
+		const double x0 = prevX, y0 = prevY, dx = X - x0, dy = Y - y0;
+		prevX = X;
+		prevY = Y;
+		double t0, t1;
+		if (!clip_segment(x0, y0, dx, dy, left, top, right, bottom, t0, t1)) {
+			finish();
+			return;
+		}
+		// Entering the box: start a new piece at the crossing
+		if (!drawing) emit(x0 + t0 * dx, y0 + t0 * dy);
+		emit(x0 + t1 * dx, y0 + t1 * dy);
+		if (t1 < 1.0) finish(); // left the box again
+	}
+
+	void finish() {
+		if (!drawing) return;
+		canvas.end_polyline();
+		drawing = false;
+	}
+
+private:
+	void emit(double X, double Y) {
+		if (!drawing) {
+			canvas.begin_polyline(stroke, width);
+			drawing = true;
+		}
+		canvas.polyline_point(X, Y);
+	}
+
+	CanvasT& canvas;
+	std::string stroke;
+	double width;
+	double left, top, right, bottom;
+	bool hasPrev{false};
+	bool drawing{false};
+	double prevX{0}, prevY{0};
+};
+
+// Samples of one line series, mapped to pixels and decimated, as
+// sink.polyline_point() calls. The sink is the canvas or a PolylineClipper.
+template<typename Sink>
+static void stream_line(Sink& sink, const SeriesSpan& span, const LineDecimation& decimation, const AxisAffine& mx, const AxisAffine& my) {
+	if (decimation.mode == LineDecimation::Mode::MinMax) {
+		MinMaxDecimator m4;
+		span.for_each_segment([&](const SampleColumn& xs, const SampleColumn& ys, size_t count, size_t base) {
+			for_each_mapped(xs, ys, count, mx, my, [&](size_t k, double X, double Y) { m4.add(base + k, X, Y, sink); });
+		});
+		m4.flush(sink);
+	} else if (decimation.mode == LineDecimation::Mode::LTTB) {
+		// Contiguous doubles take the pointer overload
+		const double* cx = span.n[1] == 0 ? span.x[0].contiguous_f64() : nullptr;
+		const double* cy = span.n[1] == 0 ? span.y[0].contiguous_f64() : nullptr;
+		std::vector<size_t> keep = cx && cy
+			? lttb_indices(cx, cy, span.size(), decimation.targetPoints, decimation.parallel)
+			: detail::lttb_indices(span.size(), decimation.targetPoints,
+				[&span](size_t k) { return span.x_at(k); }, [&span](size_t k) { return span.y_at(k); },
+				decimation.parallel);
+		for (size_t k : keep) sink.polyline_point(mx.apply(span.x_at(k)), my.apply(span.y_at(k)));
+	} else {
+		span.for_each_segment([&](const SampleColumn& xs, const SampleColumn& ys, size_t count, size_t) {
+			for_each_mapped(xs, ys, count, mx, my, [&](size_t, double X, double Y) { sink.polyline_point(X, Y); });
+		});
+	}
 }
 
-static double map_y(double y, double ymin, double ymax, double top, double bottom) {
-	if (ymax == ymin) return (top + bottom) * 0.5;
-	double t = (y - ymin) / (ymax - ymin);
-	// SVG y grows downward
-	return bottom - t * (bottom - top);
+// Density scatter: the binned counts, log-scaled into 256 colormap levels, drawn
+// as one filled rect per run of equal-level cells in a row. Empty cells are skipped.
+template<typename CanvasT>
+static void draw_density(CanvasT& canvas, const DensityGrid& grid, double left, double top, double width, double height, const ScatterMode& mode, std::pmr::memory_resource* scratch) {
+	if (grid.maxCount == 0) return;
+	const double scale = 255.0 / std::log1p(static_cast<double>(grid.maxCount));
+	std::pmr::vector<uint8_t> levels(grid.counts.size(), scratch);
+	for (size_t c = 0; c < levels.size(); ++c) {
+		// Level 0 means empty; any point gets at least level 1
+		uint32_t count = grid.counts[c];
+		levels[c] = count == 0 ? 0 : static_cast<uint8_t>(std::max(1.0, std::round(std::log1p(static_cast<double>(count)) * scale)));
+	}
+	std::array<std::string, 256> palette;
+	const double bin = mode.binPx;
+	for (int r = 0; r < grid.rows; ++r) {
+		const uint8_t* row = levels.data() + static_cast<size_t>(r) * grid.cols;
+		const double y = top + r * bin;
+		const double h = std::min(bin, height - r * bin);
+		for (int c = 0; c < grid.cols;) {
+			const uint8_t level = row[c];
+			int end = c + 1;
+			while (end < grid.cols && row[end] == level) ++end;
+			if (level != 0) {
+				std::string& fill = palette[level];
+				if (fill.empty()) fill = rgba_to_css(colormap_color(mode.colormap, (level - 1) / 254.0));
+				const double x = left + c * bin;
+				canvas.rect(x, y, std::min(end * bin, width) - c * bin, h, "none", 0.0, fill);
+			}
+			c = end;
+		}
+	}
 }
 
 std::string SvgBackend::render(
 	int widthPx, int heightPx,
 	int marginLeft, int marginRight, int marginTop, int marginBottom,
-	const std::vector<std::pair<std::vector<double>, std::vector<double>>>& lineXY,
-	const std::vector<Rgba>& lineColors,
-	const std::vector<double>& lineWidths,
-	const std::vector<std::pair<std::vector<double>, std::vector<double>>>& scatterXY,
-	const std::vector<Rgba>& scatterColors,
-	const std::vector<double>& scatterRadius,
+	const std::pmr::vector<SeriesSpan>& lineXY,
+	const std::pmr::vector<Rgba>& lineColors,
+	const std::pmr::vector<double>& lineWidths,
+	const std::pmr::vector<LineDecimation>& lineDecimation,
+	const std::pmr::vector<SeriesSpan>& scatterXY,
+	const std::pmr::vector<Rgba>& scatterColors,
+	const std::pmr::vector<double>& scatterRadius,
+	const std::pmr::vector<ScatterMode>& scatterMode,
+	const DataBounds& view,
+	bool clipToView,
+	const std::pmr::vector<SeriesFragmentCache*>& lineCache,
+	const std::pmr::vector<SeriesFragmentCache*>& scatterCache,
 	const std::string& title,
 	const std::string& xlabel,
-	const std::string& ylabel) {
+	const std::string& ylabel,
+	std::pmr::memory_resource* scratch) {
 	SvgCanvas canvas(widthPx, heightPx);
 	// delegate to the render_into overload
 	SvgBackend::render_into(canvas, widthPx, heightPx, marginLeft, marginRight, marginTop, marginBottom,
-		lineXY, lineColors, lineWidths, scatterXY, scatterColors, scatterRadius, title, xlabel, ylabel);
+		lineXY, lineColors, lineWidths, lineDecimation, scatterXY, scatterColors, scatterRadius, scatterMode, view, clipToView, lineCache, scatterCache, title, xlabel, ylabel, scratch);
 	return canvas.str();
 }
 
-void SvgBackend::render_into(SvgCanvas& canvas,
+template<typename CanvasT>
+void SvgBackend::render_into(CanvasT& canvas,
 	int widthPx, int heightPx,
 	int marginLeft, int marginRight, int marginTop, int marginBottom,
-	const std::vector<std::pair<std::vector<double>, std::vector<double>>>& lineXY,
-	const std::vector<Rgba>& lineColors,
-	const std::vector<double>& lineWidths,
-	const std::vector<std::pair<std::vector<double>, std::vector<double>>>& scatterXY,
-	const std::vector<Rgba>& scatterColors,
-	const std::vector<double>& scatterRadius,
+	const std::pmr::vector<SeriesSpan>& lineXY,
+	const std::pmr::vector<Rgba>& lineColors,
+	const std::pmr::vector<double>& lineWidths,
+	const std::pmr::vector<LineDecimation>& lineDecimation,
+	const std::pmr::vector<SeriesSpan>& scatterXY,
+	const std::pmr::vector<Rgba>& scatterColors,
+	const std::pmr::vector<double>& scatterRadius,
+	const std::pmr::vector<ScatterMode>& scatterMode,
+	const DataBounds& view,
+	bool clipToView,
+	const std::pmr::vector<SeriesFragmentCache*>& lineCache,
+	const std::pmr::vector<SeriesFragmentCache*>& scatterCache,
 	const std::string& title,
 	const std::string& xlabel,
-	const std::string& ylabel) {
+	const std::string& ylabel,
+	std::pmr::memory_resource* scratch) {
 	const double left = marginLeft;
 	const double right = widthPx - marginRight;
 	const double top = marginTop;
@@ -116,20 +321,22 @@ void SvgBackend::render_into(SvgCanvas& canvas,
 	// Axis box
 	canvas.rect(left, top, right - left, bottom - top, "black", 1.0);
 
-	// Data bounds
-	auto [xmin, xmax, ymin, ymax] = compute_data_bounds(lineXY, scatterXY);
+	// Axis limits (see Axes::view_bounds) and their pixel mapping; SVG y grows downward
+	const double xmin = view.xmin, xmax = view.xmax, ymin = view.ymin, ymax = view.ymax;
+	const AxisAffine mx = axis_affine(xmin, xmax, left, right);
+	const AxisAffine my = axis_affine(ymin, ymax, bottom, top);
 
 	// Ticks
-	auto xticks = nice_ticks(xmin, xmax, 6);
-	auto yticks = nice_ticks(ymin, ymax, 6);
+	auto xticks = nice_ticks(xmin, xmax, 6, scratch);
+	auto yticks = nice_ticks(ymin, ymax, 6, scratch);
 
 	for (double xv : xticks) {
-		double x = map_x(xv, xmin, xmax, left, right);
+		double x = mx.apply(xv);
 		canvas.line(x, bottom, x, bottom + 6, "black", 1.0);
 		canvas.text(x, bottom + 20, fmt_num(xv), "black", 12, "middle");
 	}
 	for (double yv : yticks) {
-		double y = map_y(yv, ymin, ymax, top, bottom);
+		double y = my.apply(yv);
 		canvas.line(left - 6, y, left, y, "black", 1.0);
 		canvas.text(left - 10, y + 4, fmt_num(yv), "black", 12, "end");
 	}
@@ -147,32 +354,92 @@ void SvgBackend::render_into(SvgCanvas& canvas,
 
 	// Lines
 	for (size_t i = 0; i < lineXY.size(); ++i) {
-		const auto& xs = lineXY[i].first;
-		const auto& ys = lineXY[i].second;
-		std::ostringstream pts;
-		bool first = true;
-		for (size_t k = 0; k < xs.size() && k < ys.size(); ++k) {
-			double X = map_x(xs[k], xmin, xmax, left, right);
-			double Y = map_y(ys[k], ymin, ymax, top, bottom);
-			if (!first) pts << " ";
-			pts << X << "," << Y;
-			first = false;
+		const SeriesSpan& span = lineXY[i];
+		if (clipToView) {
+			PolylineClipper<CanvasT> clipper(canvas, rgba_to_css(lineColors[i]), lineWidths[i], left, top, right, bottom);
+			stream_line(clipper, span, lineDecimation[i], mx, my);
+			clipper.finish();
+			continue;
+		}
+		// Points are streamed straight into the canvas instead of building one large string
+		canvas.begin_polyline(rgba_to_css(lineColors[i]), lineWidths[i]);
+		bool cached = false;
+		if constexpr (std::is_same_v<CanvasT, SvgCanvas>) {
+			if (lineDecimation[i].mode == LineDecimation::Mode::None && i < lineCache.size() && lineCache[i]) {
+				const std::array<double, 10> key{xmin, xmax, ymin, ymax, left, right, top, bottom, static_cast<double>(canvas.precision()), 0.0};
+				canvas.polyline_points_raw(refresh_fragment(*lineCache[i], key, span.size(), [&](std::string& out, size_t k) {
+					canvas.append_vertex(out, mx.apply(span.x_at(k)), my.apply(span.y_at(k)), k == 0);
+				}));
+				cached = true;
+			}
 		}
-		canvas.polyline(pts.str(), rgba_to_css(lineColors[i]), lineWidths[i]);
+		if (!cached) stream_line(canvas, span, lineDecimation[i], mx, my);
+		canvas.end_polyline();
 	}
 
-	// Scatter
+	// Scatter; with clipping, points whose center lies outside the limits are dropped
+	auto in_view = [&](double x, double y) { return x >= xmin && x <= xmax && y >= ymin && y <= ymax; };
 	for (size_t i = 0; i < scatterXY.size(); ++i) {
-		const auto& xs = scatterXY[i].first;
-		const auto& ys = scatterXY[i].second;
-		for (size_t k = 0; k < xs.size() && k < ys.size(); ++k) {
-			double X = map_x(xs[k], xmin, xmax, left, right);
-			double Y = map_y(ys[k], ymin, ymax, top, bottom);
-			canvas.circle(X, Y, scatterRadius[i], rgba_to_css(scatterColors[i]));
+		// Scatter series are a single segment
+		const SampleColumn& xs = scatterXY[i].x[0];
+		const SampleColumn& ys = scatterXY[i].y[0];
+		const size_t n = scatterXY[i].n[0];
+		if (scatterMode[i].mode == ScatterMode::Mode::Density) {
+			DensityGrid grid = bin_density(xs, ys, n, xmin, xmax, ymin, ymax,
+				right - left, bottom - top, scatterMode[i].binPx, scatterMode[i].parallel, scratch);
+			draw_density(canvas, grid, left, top, right - left, bottom - top, scatterMode[i], scratch);
+			continue;
 		}
+		// Color resolved once per series; points only carry coordinates
+		canvas.begin_markers(rgba_to_css(scatterColors[i]), scatterRadius[i]);
+		// Same-colored opaque circles at one position are indistinguishable from one
+		if (scatterMode[i].dedup && scatterColors[i].a >= 1.0 && n > 1) {
+			for (size_t k : dedup_points(xs, ys, n, mx, my, emitted_precision(canvas), clipToView ? &view : nullptr, scratch)) {
+				canvas.marker(mx.apply(xs.at(k)), my.apply(ys.at(k)));
+			}
+			canvas.end_markers();
+			continue;
+		}
+		if constexpr (std::is_same_v<CanvasT, SvgCanvas>) {
+			if (!clipToView && i < scatterCache.size() && scatterCache[i]) {
+				const std::array<double, 10> key{xmin, xmax, ymin, ymax, left, right, top, bottom, static_cast<double>(canvas.precision()), scatterRadius[i]};
+				const std::string& text = refresh_fragment(*scatterCache[i], key, n, [&](std::string& out, size_t k) {
+					canvas.append_marker(out, mx.apply(xs.at(k)), my.apply(ys.at(k)));
+				});
+				canvas.write_fragment(text.data(), text.size());
+				canvas.end_markers();
+				continue;
+			}
+		}
+		for_each_mapped(xs, ys, n, mx, my, [&](size_t k, double X, double Y) {
+			if (!clipToView || in_view(xs.at(k), ys.at(k))) canvas.marker(X, Y);
+		});
+		canvas.end_markers();
 	}
 }
 
-} // namespace catplot
-
+// Canvas types the layout pass is compiled for
+#define CATPLOT_INSTANTIATE_RENDER_INTO(CanvasT) \
+	template void SvgBackend::render_into<CanvasT>(CanvasT& canvas, \
+		int widthPx, int heightPx, \
+		int marginLeft, int marginRight, int marginTop, int marginBottom, \
+		const std::pmr::vector<SeriesSpan>& lineXY, \
+		const std::pmr::vector<Rgba>& lineColors, \
+		const std::pmr::vector<double>& lineWidths, \
+		const std::pmr::vector<LineDecimation>& lineDecimation, \
+		const std::pmr::vector<SeriesSpan>& scatterXY, \
+		const std::pmr::vector<Rgba>& scatterColors, \
+		const std::pmr::vector<double>& scatterRadius, \
+		const std::pmr::vector<ScatterMode>& scatterMode, \
+		const DataBounds& view, \
+		bool clipToView, \
+		const std::pmr::vector<SeriesFragmentCache*>& lineCache, \
+		const std::pmr::vector<SeriesFragmentCache*>& scatterCache, \
+		const std::string& title, \
+		const std::string& xlabel, \
+		const std::string& ylabel, \
+		std::pmr::memory_resource* scratch);
+CATPLOT_FOR_EACH_CANVAS(CATPLOT_INSTANTIATE_RENDER_INTO)
+#undef CATPLOT_INSTANTIATE_RENDER_INTO
 
+} // namespace catplot
@@ -1,45 +1,71 @@
 #pragma once
 
+#include "canvas.hpp"
 #include "svg_canvas.hpp"
+#include "series_span.hpp"
 #include "catplot/axes.hpp"
+#include <cstdio>
+#include <memory_resource>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace catplot {
 
+// %g matches the default ostream formatting of the alpha value
 inline std::string rgba_to_css(const Rgba& c) {
-	std::ostringstream ss;
-	ss << "rgba(" << int(c.r * 255.0 + 0.5) << "," << int(c.g * 255.0 + 0.5) << "," << int(c.b * 255.0 + 0.5) << "," << c.a << ")";
-	return ss.str();
+	char buf[64];
+	int n = std::snprintf(buf, sizeof(buf), "rgba(%d,%d,%d,%g)", int(c.r * 255.0 + 0.5), int(c.g * 255.0 + 0.5), int(c.b * 255.0 + 0.5), c.a);
+	return std::string(buf, static_cast<std::size_t>(n));
 }
 
 class SvgBackend {
 public:
 	static std::string render(int widthPx, int heightPx,
 		int marginLeft, int marginRight, int marginTop, int marginBottom,
-		const std::vector<std::pair<std::vector<double>, std::vector<double>>>& lineXY,
-		const std::vector<Rgba>& lineColors,
-		const std::vector<double>& lineWidths,
-		const std::vector<std::pair<std::vector<double>, std::vector<double>>>& scatterXY,
-		const std::vector<Rgba>& scatterColors,
-		const std::vector<double>& scatterRadius,
+		const std::pmr::vector<SeriesSpan>& lineXY,
+		const std::pmr::vector<Rgba>& lineColors,
+		const std::pmr::vector<double>& lineWidths,
+		const std::pmr::vector<LineDecimation>& lineDecimation,
+		const std::pmr::vector<SeriesSpan>& scatterXY,
+		const std::pmr::vector<Rgba>& scatterColors,
+		const std::pmr::vector<double>& scatterRadius,
+		const std::pmr::vector<ScatterMode>& scatterMode,
+		const DataBounds& view,
+		bool clipToView,
+		const std::pmr::vector<SeriesFragmentCache*>& lineCache,
+		const std::pmr::vector<SeriesFragmentCache*>& scatterCache,
 		const std::string& title,
 		const std::string& xlabel,
-		const std::string& ylabel);
+		const std::string& ylabel,
+		std::pmr::memory_resource* scratch);
 
-	// Overload: render into an existing canvas at 0,0 with width/height; margins still apply inside
-	static void render_into(SvgCanvas& canvas, int widthPx, int heightPx,
+	// Overload: render into an existing canvas at 0,0 with width/height; margins still apply inside.
+	// CanvasT is any canvas from canvas.hpp (explicitly instantiated in svg_backend.cpp).
+	// `view` holds the axis limits (see Axes::view_bounds); with clipToView the
+	// samples outside them are culled and lines are split at the plot box.
+	// lineCache/scatterCache hold an optional per-series fragment cache (nullptr
+	// entries or empty vectors disable it); only SvgCanvas uses them.
+	// Per-series scratch buffers are allocated from `scratch` (see RenderArena).
+	template<typename CanvasT>
+	static void render_into(CanvasT& canvas, int widthPx, int heightPx,
 		int marginLeft, int marginRight, int marginTop, int marginBottom,
-		const std::vector<std::pair<std::vector<double>, std::vector<double>>>& lineXY,
-		const std::vector<Rgba>& lineColors,
-		const std::vector<double>& lineWidths,
-		const std::vector<std::pair<std::vector<double>, std::vector<double>>>& scatterXY,
-		const std::vector<Rgba>& scatterColors,
-		const std::vector<double>& scatterRadius,
+		const std::pmr::vector<SeriesSpan>& lineXY,
+		const std::pmr::vector<Rgba>& lineColors,
+		const std::pmr::vector<double>& lineWidths,
+		const std::pmr::vector<LineDecimation>& lineDecimation,
+		const std::pmr::vector<SeriesSpan>& scatterXY,
+		const std::pmr::vector<Rgba>& scatterColors,
+		const std::pmr::vector<double>& scatterRadius,
+		const std::pmr::vector<ScatterMode>& scatterMode,
+		const DataBounds& view,
+		bool clipToView,
+		const std::pmr::vector<SeriesFragmentCache*>& lineCache,
+		const std::pmr::vector<SeriesFragmentCache*>& scatterCache,
 		const std::string& title,
 		const std::string& xlabel,
-		const std::string& ylabel);
+		const std::string& ylabel,
+		std::pmr::memory_resource* scratch);
 };
 
 } // namespace catplot
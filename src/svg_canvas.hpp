@@ -1,61 +1,281 @@
 #pragma once
 
-#include <sstream>
+#include "number_format.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace catplot {
 
+// Receives chunks of finished SVG output
+using SvgSink = std::function<void(const char* data, std::size_t size)>;
+
+// Fixed-capacity stream buffer: output is collected in `capacity` bytes and
+// handed to the sink whenever the buffer fills up or is flushed, so memory
+// use stays bounded regardless of document size.
+class SvgSinkBuf : public std::streambuf {
+public:
+	SvgSinkBuf(SvgSink sinkFn, std::size_t capacity)
+		: sink(std::move(sinkFn)), buffer(capacity > 0 ? capacity : 1) {
+		setp(buffer.data(), buffer.data() + buffer.size());
+	}
+
+	void flush_to_sink() {
+		std::size_t n = static_cast<std::size_t>(pptr() - pbase());
+		if (n > 0) sink(pbase(), n);
+		setp(buffer.data(), buffer.data() + buffer.size());
+	}
+
+protected:
+	int_type overflow(int_type ch) override {
+		flush_to_sink();
+		if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+			*pptr() = traits_type::to_char_type(ch);
+			pbump(1);
+		}
+		return traits_type::not_eof(ch);
+	}
+
+	std::streamsize xsputn(const char* s, std::streamsize n) override {
+		std::streamsize written = 0;
+		while (written < n) {
+			std::streamsize room = epptr() - pptr();
+			if (room == 0) {
+				flush_to_sink();
+				room = epptr() - pptr();
+			}
+			std::streamsize chunk = std::min(room, n - written);
+			traits_type::copy(pptr(), s + written, static_cast<std::size_t>(chunk));
+			pbump(static_cast<int>(chunk));
+			written += chunk;
+		}
+		return written;
+	}
+
+	int sync() override {
+		flush_to_sink();
+		return 0;
+	}
+
+private:
+	SvgSink sink;
+	std::vector<char> buffer;
+};
+
 class SvgCanvas {
 public:
+	static constexpr std::size_t kDefaultBufferBytes = 64 * 1024;
+
+	// In-memory canvas; retrieve the document with str()
 	SvgCanvas(int widthPx, int heightPx)
-		: width(widthPx), height(heightPx) {
+		: SvgCanvas(widthPx, heightPx, [this](const char* data, std::size_t n) { memory.append(data, n); }, kDefaultBufferBytes) {
+		inMemory = true;
+	}
+
+	// Streaming canvas writing to any std::ostream through a bounded buffer
+	SvgCanvas(int widthPx, int heightPx, std::ostream& out, std::size_t bufferBytes = kDefaultBufferBytes)
+		: SvgCanvas(widthPx, heightPx, [&out](const char* data, std::size_t n) {
+			out.write(data, static_cast<std::streamsize>(n));
+			if (!out) throw std::runtime_error("Error writing SVG output");
+		}, bufferBytes) {}
+
+	// Streaming canvas handing chunks of at most bufferBytes to a callback
+	SvgCanvas(int widthPx, int heightPx, SvgSink sink, std::size_t bufferBytes = kDefaultBufferBytes)
+		: width(widthPx), height(heightPx), buf(std::move(sink), bufferBytes), ss(&buf) {
+		rethrow_sink_errors();
 		ss << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height << "\" viewBox=\"0 0 " << width << " " << height << "\">";
 		ss << "<rect x=\"0\" y=\"0\" width=\"" << width << "\" height=\"" << height << "\" fill=\"white\"/>";
 	}
 
+	// Tag for fragment canvases: no <svg> header or closing tag, so the output
+	// can be spliced into another canvas with write_fragment()
+	struct Fragment {};
+
+	SvgCanvas(Fragment, SvgSink sink, std::size_t bufferBytes = kDefaultBufferBytes)
+		: width(0), height(0), fragment(true), buf(std::move(sink), bufferBytes), ss(&buf) {
+		rethrow_sink_errors();
+	}
+
+	SvgCanvas(const SvgCanvas&) = delete;
+	SvgCanvas& operator=(const SvgCanvas&) = delete;
+
+	// Significant digits for emitted numbers (default 6, same as iostream)
+	void set_precision(int significantDigits) { formatter.set_precision(significantDigits); }
+	int precision() const { return formatter.precision(); }
+
 	void line(double x1, double y1, double x2, double y2, const std::string& stroke, double strokeWidth, const std::string& linecap = "round") {
-		ss << "<line x1=\"" << x1 << "\" y1=\"" << y1 << "\" x2=\"" << x2 << "\" y2=\"" << y2
-		   << "\" stroke=\"" << stroke << "\" stroke-width=\"" << strokeWidth << "\" stroke-linecap=\"" << linecap << "\" fill=\"none\"/>";
+		ss << "<line x1=\"" << num(x1) << "\" y1=\"" << num(y1) << "\" x2=\"" << num(x2) << "\" y2=\"" << num(y2)
+		   << "\" stroke=\"" << stroke << "\" stroke-width=\"" << num(strokeWidth) << "\" stroke-linecap=\"" << linecap << "\" fill=\"none\"/>";
 	}
 
 	void polyline(const std::string& points, const std::string& stroke, double strokeWidth) {
-		ss << "<polyline points=\"" << points << "\" stroke=\"" << stroke << "\" stroke-width=\"" << strokeWidth << "\" fill=\"none\" stroke-linecap=\"round\" stroke-linejoin=\"round\"/>";
+		begin_polyline(stroke, strokeWidth);
+		ss << points;
+		end_polyline();
+	}
+
+	// Streamed polyline: begin_polyline(), one polyline_point() per vertex, end_polyline()
+	void begin_polyline(const std::string& stroke, double strokeWidth) {
+		ss << "<polyline points=\"";
+		polylineStroke = stroke;
+		polylineWidth = strokeWidth;
+		firstPoint = true;
+	}
+	void polyline_point(double x, double y) {
+		// Hot path: format the vertex into a local buffer and hand it to the stream buffer in one call
+		char tmp[kMaxVertexChars];
+		buf.sputn(tmp, static_cast<std::streamsize>(format_vertex(x, y, firstPoint, tmp)));
+		firstPoint = false;
+	}
+	// Vertices formatted earlier with append_vertex(), written into the open polyline
+	void polyline_points_raw(const std::string& text) {
+		if (text.empty()) return;
+		buf.sputn(text.data(), static_cast<std::streamsize>(text.size()));
+		firstPoint = false;
+	}
+	// Formatting of polyline_point(), for callers that cache formatted vertices
+	void append_vertex(std::string& out, double x, double y, bool first) const {
+		char tmp[kMaxVertexChars];
+		out.append(tmp, format_vertex(x, y, first, tmp));
+	}
+	void end_polyline() {
+		ss << "\" stroke=\"" << polylineStroke << "\" stroke-width=\"" << num(polylineWidth) << "\" fill=\"none\" stroke-linecap=\"round\" stroke-linejoin=\"round\"/>";
 	}
 
 	void circle(double cx, double cy, double r, const std::string& fill) {
-		ss << "<circle cx=\"" << cx << "\" cy=\"" << cy << "\" r=\"" << r << "\" fill=\"" << fill << "\"/>";
+		ss << "<circle cx=\"" << num(cx) << "\" cy=\"" << num(cy) << "\" r=\"" << num(r) << "\" fill=\"" << fill << "\"/>";
+	}
+
+	// Streamed markers sharing one fill and radius: begin_markers(), one marker() per
+	// point, end_markers(). The fill is set once on an enclosing <g>, so each point
+	// only carries its coordinates.
+	void begin_markers(const std::string& fill, double r) {
+		ss << "<g fill=\"" << fill << "\">";
+		markerTail = "\" r=\"";
+		char tmp[NumberFormatter::kMaxChars];
+		markerTail.append(tmp, formatter.format(r, tmp));
+		markerTail += "\"/>";
+	}
+	void marker(double cx, double cy) {
+		char tmp[kMaxMarkerHeadChars];
+		buf.sputn(tmp, static_cast<std::streamsize>(format_marker_head(cx, cy, tmp)));
+		buf.sputn(markerTail.data(), static_cast<std::streamsize>(markerTail.size()));
+	}
+	// Formatting of marker() for the radius of the current begin_markers()
+	void append_marker(std::string& out, double cx, double cy) const {
+		char tmp[kMaxMarkerHeadChars];
+		out.append(tmp, format_marker_head(cx, cy, tmp));
+		out += markerTail;
+	}
+	void end_markers() {
+		ss << "</g>";
 	}
 
 	void text(double x, double y, const std::string& content, const std::string& fill = "black", int fontSize = 12, const std::string& anchor = "start", double rotateDeg = 0.0) {
-		ss << "<text x=\"" << x << "\" y=\"" << y << "\" fill=\"" << fill << "\" font-family=\"sans-serif\" font-size=\"" << fontSize << "\" text-anchor=\"" << anchor << "\"";
+		ss << "<text x=\"" << num(x) << "\" y=\"" << num(y) << "\" fill=\"" << fill << "\" font-family=\"sans-serif\" font-size=\"" << fontSize << "\" text-anchor=\"" << anchor << "\"";
 		if (rotateDeg != 0.0) {
-			ss << " transform=\"rotate(" << rotateDeg << " " << x << " " << y << ")\"";
+			ss << " transform=\"rotate(" << num(rotateDeg) << " " << num(x) << " " << num(y) << ")\"";
 		}
 		ss << ">" << escape(content) << "</text>";
 	}
 
 	void rect(double x, double y, double w, double h, const std::string& stroke, double strokeWidth, const std::string& fill = "none") {
-		ss << "<rect x=\"" << x << "\" y=\"" << y << "\" width=\"" << w << "\" height=\"" << h << "\" stroke=\"" << stroke
-		   << "\" stroke-width=\"" << strokeWidth << "\" fill=\"" << fill << "\"/>";
+		ss << "<rect x=\"" << num(x) << "\" y=\"" << num(y) << "\" width=\"" << num(w) << "\" height=\"" << num(h) << "\" stroke=\"" << stroke
+		   << "\" stroke-width=\"" << num(strokeWidth) << "\" fill=\"" << fill << "\"/>";
 	}
 
 	void begin_group_translate(double tx, double ty) {
-		ss << "<g transform=\"translate(" << tx << "," << ty << ")\">";
+		ss << "<g transform=\"translate(" << num(tx) << "," << num(ty) << ")\">";
 	}
 	void end_group() {
 		ss << "</g>";
 	}
 
+	// Append already formatted SVG elements (the output of a fragment canvas)
+	void write_fragment(const char* data, std::size_t size) {
+		buf.sputn(data, static_cast<std::streamsize>(size));
+	}
+
+	// Close the document and flush everything to the sink (idempotent)
+	void finish() {
+		if (finished) return;
+		if (!fragment) ss << "</svg>";
+		buf.flush_to_sink();
+		finished = true;
+	}
+
+	// Finished document of an in-memory canvas
 	std::string str() {
-		std::ostringstream out;
-		out << ss.str() << "</svg>";
-		return out.str();
+		if (!inMemory) throw std::logic_error("SvgCanvas::str() requires an in-memory canvas");
+		finish();
+		return memory;
 	}
 
 private:
+	// Number wrapper so coordinates bypass iostream's locale-aware double formatting
+	struct FormattedNumber {
+		double value;
+		const NumberFormatter& formatter;
+		friend std::ostream& operator<<(std::ostream& os, const FormattedNumber& n) {
+			char tmp[NumberFormatter::kMaxChars];
+			std::size_t len = n.formatter.format(n.value, tmp);
+			os.rdbuf()->sputn(tmp, static_cast<std::streamsize>(len));
+			return os;
+		}
+	};
+	FormattedNumber num(double v) const { return FormattedNumber{v, formatter}; }
+
+	// A sink that throws inside an insertion would otherwise only set badbit:
+	// later insertions would be skipped while the sputn() paths keep writing
+	void rethrow_sink_errors() { ss.exceptions(std::ios::badbit); }
+
+	static constexpr char kMarkerHead[] = "<circle cx=\"";
+	static constexpr char kMarkerMid[] = "\" cy=\"";
+	static constexpr std::size_t kMaxVertexChars = 2 * NumberFormatter::kMaxChars + 2;
+	static constexpr std::size_t kMaxMarkerHeadChars = 2 * NumberFormatter::kMaxChars + sizeof kMarkerHead + sizeof kMarkerMid;
+
+	// "x,y", preceded by a space unless it is the first vertex
+	std::size_t format_vertex(double x, double y, bool first, char* out) const {
+		std::size_t n = 0;
+		if (!first) out[n++] = ' ';
+		n += formatter.format(x, out + n);
+		out[n++] = ',';
+		n += formatter.format(y, out + n);
+		return n;
+	}
+
+	// `<circle cx="..." cy="...` (the radius tail is shared per series)
+	std::size_t format_marker_head(double cx, double cy, char* out) const {
+		std::size_t n = 0;
+		std::memcpy(out, kMarkerHead, sizeof kMarkerHead - 1);
+		n += sizeof kMarkerHead - 1;
+		n += formatter.format(cx, out + n);
+		std::memcpy(out + n, kMarkerMid, sizeof kMarkerMid - 1);
+		n += sizeof kMarkerMid - 1;
+		n += formatter.format(cy, out + n);
+		return n;
+	}
+
 	int width;
 	int height;
-	std::ostringstream ss;
+	NumberFormatter formatter;
+	std::string memory;
+	bool inMemory{false};
+	bool fragment{false};
+	bool finished{false};
+	bool firstPoint{true};
+	std::string polylineStroke;
+	double polylineWidth{1.0};
+	std::string markerTail;
+	SvgSinkBuf buf;
+	std::ostream ss;
 
 	static std::string escape(const std::string& s) {
 		std::string out;
@@ -0,0 +1,41 @@
+#include "thread_pool.hpp"
+
+namespace catplot {
+
+ThreadPool::ThreadPool(unsigned workers) {
+	threads.reserve(workers);
+	for (unsigned i = 0; i < workers; ++i) threads.emplace_back([this] { worker_loop(); });
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto& t : threads) t.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	wake.notify_one();
+}
+
+void ThreadPool::worker_loop() {
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty()) return; // stopping and drained
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
+
+} // namespace catplot
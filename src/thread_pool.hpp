@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace catplot {
+
+// Fixed set of worker threads running queued tasks. parallel_for() may be
+// called from several threads at once; each call has its own index counter and
+// completion state.
+class ThreadPool {
+public:
+	// Spawns `workers` threads (0 is allowed: every parallel_for then runs on the caller)
+	explicit ThreadPool(unsigned workers);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+	// Run fn(i) for every i in [0, n) and wait for all of them. The calling
+	// thread takes part; indices are handed out dynamically. The first
+	// exception thrown by fn is rethrown here once all tasks have stopped.
+	template<typename F>
+	void parallel_for(std::size_t n, F&& fn);
+
+private:
+	void submit(std::function<void()> task);
+	void worker_loop();
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<std::function<void()>> tasks;
+	bool stopping{false};
+};
+
+template<typename F>
+void ThreadPool::parallel_for(std::size_t n, F&& fn) {
+	if (n == 0) return;
+	struct State {
+		std::atomic<std::size_t> next{0};
+		std::mutex mutex;
+		std::condition_variable done;
+		std::size_t running{0};
+		std::exception_ptr error;
+	} state;
+
+	auto drain = [&state, &fn, n] {
+		for (std::size_t i = state.next++; i < n; i = state.next++) {
+			try {
+				fn(i);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(state.mutex);
+				if (!state.error) state.error = std::current_exception();
+				state.next = n; // stop handing out work
+			}
+		}
+	};
+
+	const std::size_t helpers = std::min<std::size_t>(threads.size(), n - 1);
+	state.running = helpers;
+	for (std::size_t h = 0; h < helpers; ++h) {
+		submit([&state, &drain] {
+			drain();
+			std::lock_guard<std::mutex> lock(state.mutex);
+			if (--state.running == 0) state.done.notify_one();
+		});
+	}
+	drain();
+	std::unique_lock<std::mutex> lock(state.mutex);
+	state.done.wait(lock, [&state] { return state.running == 0; });
+	if (state.error) std::rethrow_exception(state.error);
+}
+
+} // namespace catplot
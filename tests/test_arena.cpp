@@ -0,0 +1,124 @@
+#include <iostream>
+#include <cassert>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+#include "render_arena.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+// `series` line and scatter pairs of n points each
+Figure make_figure(size_t n, int series) {
+	Figure fig(800, 600);
+	std::vector<double> x(n), y(n);
+	for (size_t i = 0; i < n; ++i) {
+		x[i] = static_cast<double>(i);
+		y[i] = static_cast<double>(i % 7);
+	}
+	for (int k = 0; k < series; ++k) {
+		fig.axes().plot(x, y);
+		fig.axes().scatter(x, y);
+	}
+	return fig;
+}
+
+ArenaStats save_stats(const Figure& fig) {
+	std::ostringstream out;
+	fig.save(out);
+	return fig.last_render_arena();
+}
+
+bool same_stats(const ArenaStats& a, const ArenaStats& b) {
+	return a.allocations == b.allocations && a.bytes == b.bytes && a.blocks == b.blocks;
+}
+
+// Counts the blocks handed out to arenas on this thread
+class CountingResource final : public std::pmr::memory_resource {
+public:
+	size_t allocations{0};
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+TEST_CASE(test_counts_do_not_depend_on_points) {
+	const ArenaStats small = save_stats(make_figure(100, 1));
+	const ArenaStats large = save_stats(make_figure(200000, 1));
+	assert(small.allocations > 0);
+	assert(same_stats(small, large));
+	// A few series fit in the arena's inline storage
+	assert(small.blocks == 0);
+
+	// More series need more scratch memory, but not more heap blocks
+	const ArenaStats more = save_stats(make_figure(100, 3));
+	assert(more.bytes > small.bytes);
+	assert(more.blocks == 0);
+}
+
+TEST_CASE(test_measure_and_save_agree) {
+	Figure fig = make_figure(1000, 2);
+	const ArenaStats saved = save_stats(fig);
+	fig.measure();
+	assert(same_stats(fig.last_render_arena(), saved));
+
+	// Subplots each render with their own arena; the figure reports the sum
+	Figure grid(800, 600);
+	std::vector<double> x = {0, 1, 2}, y = {2, 0, 1};
+	for (int i = 1; i <= 4; ++i) grid.subplot(2, 2, i).plot(x, y);
+	const ArenaStats total = save_stats(grid);
+	ArenaStats sum;
+	for (int i = 1; i <= 4; ++i) {
+		ArenaStats a = grid.subplot(2, 2, i).last_render_arena();
+		sum.allocations += a.allocations;
+		sum.bytes += a.bytes;
+		sum.blocks += a.blocks;
+	}
+	assert(same_stats(total, sum));
+	grid.set_render_threads(4);
+	assert(same_stats(save_stats(grid), total));
+}
+
+TEST_CASE(test_heap_blocks_come_from_thread_heap) {
+	// Enough series to outgrow the inline storage
+	Figure fig = make_figure(10, 400);
+	const ArenaStats plain = save_stats(fig);
+	assert(plain.blocks > 0);
+
+	std::ostringstream expected;
+	fig.save(expected);
+	CountingResource heap;
+	{
+		ScopedArenaHeap scope(&heap);
+		std::ostringstream out;
+		fig.save(out);
+		assert(out.str() == expected.str());
+	}
+	assert(heap.allocations == plain.blocks);
+	assert(thread_arena_heap() == nullptr);
+}
+
+int main() {
+	std::cout << "Running render arena tests...\n";
+
+	RUN_TEST(test_counts_do_not_depend_on_points);
+	RUN_TEST(test_measure_and_save_agree);
+	RUN_TEST(test_heap_blocks_come_from_thread_heap);
+
+	std::cout << "All render arena tests passed!\n";
+	return 0;
+}
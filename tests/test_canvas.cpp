@@ -0,0 +1,159 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+#include "counting_canvas.hpp"
+#include "display_list.hpp"
+#include "svg_canvas.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+// One line, one scatter, labels, grid and legend: every primitive kind
+void fill(Axes& ax) {
+	std::vector<double> x, y, sx, sy;
+	for (int i = 0; i < 50; ++i) {
+		x.push_back(i * 0.2);
+		y.push_back(std::sin(i * 0.2));
+	}
+	for (int i = 0; i < 20; ++i) {
+		sx.push_back(i * 0.5);
+		sy.push_back(std::cos(i * 0.5));
+	}
+	ax.plot(x, y, Rgba::Blue(), 2.0, "sin");
+	ax.scatter(sx, sy, 3.0, Rgba::Red(), "cos");
+	ax.set_title("canvas");
+	ax.set_xlabel("x");
+	ax.set_ylabel("y");
+	ax.grid(true);
+	ax.legend(true);
+}
+
+bool same_stats(const RenderStats& a, const RenderStats& b) {
+	return a.lines == b.lines && a.polylines == b.polylines && a.polylinePoints == b.polylinePoints &&
+		a.circles == b.circles && a.rects == b.rects && a.texts == b.texts && a.textChars == b.textChars &&
+		a.groups == b.groups && a.minX == b.minX && a.minY == b.minY && a.maxX == b.maxX && a.maxY == b.maxY;
+}
+
+TEST_CASE(test_replay_matches_direct_svg) {
+	Axes ax(640, 480);
+	fill(ax);
+
+	SvgCanvas direct(640, 480);
+	ax.render_to(direct, 0, 0, 640, 480);
+	direct.finish();
+
+	DisplayListCanvas list(640, 480);
+	ax.render_to(list, 0, 0, 640, 480);
+	SvgCanvas replayed(list.width(), list.height());
+	list.replay(replayed);
+	replayed.finish();
+	assert(replayed.str() == direct.str());
+
+	// A copy of the bytes replays the same way
+	std::vector<uint8_t> bytes = list.bytes();
+	SvgCanvas copied(640, 480);
+	DisplayListCanvas::replay(bytes.data(), bytes.size(), copied);
+	copied.finish();
+	assert(copied.str() == direct.str());
+}
+
+TEST_CASE(test_counting_matches_replay) {
+	Axes ax(640, 480);
+	fill(ax);
+
+	CountingCanvas direct;
+	ax.render_to(direct, 0, 0, 640, 480);
+	DisplayListCanvas list(640, 480);
+	ax.render_to(list, 0, 0, 640, 480);
+	CountingCanvas replayed;
+	list.replay(replayed);
+	assert(same_stats(direct.stats(), replayed.stats()));
+
+	const RenderStats& s = direct.stats();
+	assert(s.polylines == 1 && s.polylinePoints == 50);
+	assert(s.circles >= 20);
+	assert(s.texts >= 3);
+	assert(s.minX >= 0 && s.maxX <= 640 && s.minY >= 0 && s.maxY <= 480);
+}
+
+TEST_CASE(test_measure_matches_threads) {
+	Figure fig(800, 600);
+	for (int i = 1; i <= 4; ++i) fill(fig.subplot(2, 2, i));
+	const RenderStats serial = fig.measure();
+	assert(serial.polylines == 4 && serial.polylinePoints == 200);
+
+	// Parallel cells are recorded into display lists and replayed in order
+	fig.set_render_threads(4);
+	assert(same_stats(fig.measure(), serial));
+}
+
+TEST_CASE(test_malformed_list_throws) {
+	Axes ax(640, 480);
+	fill(ax);
+	DisplayListCanvas list(640, 480);
+	ax.render_to(list, 0, 0, 640, 480);
+	const std::vector<uint8_t>& bytes = list.bytes();
+
+	bool threw = false;
+	CountingCanvas sink;
+	try { DisplayListCanvas::replay(bytes.data(), bytes.size() - 3, sink); } catch (const std::runtime_error&) { threw = true; }
+	assert(threw);
+
+	std::vector<uint8_t> bad = bytes;
+	bad[0] = 'X';
+	threw = false;
+	try { DisplayListCanvas::replay(bad.data(), bad.size(), sink); } catch (const std::runtime_error&) { threw = true; }
+	assert(threw);
+}
+
+struct SinkFailure {};
+
+TEST_CASE(test_sink_errors_propagate) {
+	Axes ax(640, 480);
+	fill(ax);
+	// Each run fails one chunk; with a small buffer the failure lands in every
+	// kind of write, and none may be swallowed
+	size_t chunks = 0;
+	{
+		SvgCanvas canvas(640, 480, [&chunks](const char*, size_t) { ++chunks; }, 16);
+		ax.render_to(canvas, 0, 0, 640, 480);
+		canvas.finish();
+	}
+	assert(chunks > 100);
+	for (size_t failAt = 1; failAt <= chunks; ++failAt) {
+		size_t calls = 0;
+		bool threw = false;
+		try {
+			SvgCanvas canvas(640, 480, [&calls, failAt](const char*, size_t) {
+				if (++calls == failAt) throw SinkFailure{};
+			}, 16);
+			ax.render_to(canvas, 0, 0, 640, 480);
+			canvas.finish();
+		} catch (const SinkFailure&) {
+			threw = true;
+		}
+		assert(threw);
+	}
+}
+
+int main() {
+	std::cout << "Running canvas tests...\n";
+
+	RUN_TEST(test_replay_matches_direct_svg);
+	RUN_TEST(test_counting_matches_replay);
+	RUN_TEST(test_measure_matches_threads);
+	RUN_TEST(test_malformed_list_throws);
+	RUN_TEST(test_sink_errors_propagate);
+
+	std::cout << "All canvas tests passed!\n";
+	return 0;
+}
@@ -0,0 +1,146 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+#include "display_list.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+struct Point {
+	double x, y;
+};
+using Pieces = std::vector<std::vector<Point>>;
+
+struct PolylineRecorder {
+	Pieces polylines;
+
+	void line(double, double, double, double, const std::string&, double, const std::string&) {}
+	void begin_polyline(const std::string&, double) { polylines.emplace_back(); }
+	void polyline_point(double x, double y) { polylines.back().push_back({x, y}); }
+	void end_polyline() {}
+	void circle(double, double, double, const std::string&) {}
+	void begin_markers(const std::string&, double) {}
+	void marker(double, double) {}
+	void end_markers() {}
+	void text(double, double, const std::string&, const std::string&, int, const std::string&, double) {}
+	void rect(double, double, double, double, const std::string&, double, const std::string&) {}
+	void begin_group_translate(double, double) {}
+	void end_group() {}
+};
+
+// Plot box of an 800x600 Axes with the default margins
+constexpr double kLeft = 70, kRight = 780, kTop = 30, kBottom = 540;
+
+// Visible pieces of the polyline through (x, y) with limits [0, 10] on both
+// axes, mapped back to data coordinates
+Pieces clip(const std::vector<double>& x, const std::vector<double>& y) {
+	Axes ax(800, 600);
+	ax.plot(x, y);
+	ax.set_xlim(0, 10);
+	ax.set_ylim(0, 10);
+	DisplayListCanvas list(800, 600);
+	ax.render_to(list, 0, 0, 800, 600);
+	PolylineRecorder rec;
+	list.replay(rec);
+	for (auto& piece : rec.polylines) {
+		for (Point& p : piece) {
+			// Nothing may be drawn outside the plot box
+			assert(p.x >= kLeft && p.x <= kRight && p.y >= kTop && p.y <= kBottom);
+			p = {(p.x - kLeft) / (kRight - kLeft) * 10.0, (kBottom - p.y) / (kBottom - kTop) * 10.0};
+		}
+	}
+	return rec.polylines;
+}
+
+bool near(const Point& p, double x, double y) {
+	return std::abs(p.x - x) < 1e-9 && std::abs(p.y - y) < 1e-9;
+}
+
+void check_piece(const std::vector<Point>& piece, const std::vector<Point>& expected) {
+	assert(piece.size() == expected.size());
+	for (size_t i = 0; i < piece.size(); ++i) assert(near(piece[i], expected[i].x, expected[i].y));
+}
+
+TEST_CASE(test_inside_and_outside) {
+	Pieces p = clip({1, 9}, {1, 9});
+	assert(p.size() == 1);
+	check_piece(p[0], {{1, 1}, {9, 9}});
+
+	assert(clip({-5, -1}, {-5, -1}).empty());
+	assert(clip({11, 20}, {5, 5}).empty());
+	// Crosses the corner region without touching the box
+	assert(clip({-1, 0.5}, {0.5, -1}).empty());
+}
+
+TEST_CASE(test_crossing_edges) {
+	Pieces p = clip({-5, 5}, {5, 5});
+	assert(p.size() == 1);
+	check_piece(p[0], {{0, 5}, {5, 5}});
+
+	// Vertical and horizontal segments crossing two opposite edges
+	p = clip({3, 3}, {-5, 15});
+	assert(p.size() == 1);
+	check_piece(p[0], {{3, 0}, {3, 10}});
+	p = clip({15, -5}, {7, 7});
+	assert(p.size() == 1);
+	check_piece(p[0], {{10, 7}, {0, 7}});
+
+	// Leaves through the right edge and comes back in
+	p = clip({5, 15, 5}, {5, 5, 6});
+	assert(p.size() == 2);
+	check_piece(p[0], {{5, 5}, {10, 5}});
+	check_piece(p[1], {{10, 5.5}, {5, 6}});
+}
+
+TEST_CASE(test_corners_and_edges) {
+	// Diagonal through two opposite corners
+	Pieces p = clip({-1, 11}, {-1, 11});
+	assert(p.size() == 1);
+	check_piece(p[0], {{0, 0}, {10, 10}});
+
+	// Touches a single corner
+	p = clip({-1, 1}, {1, -1});
+	for (const auto& piece : p) {
+		for (const Point& q : piece) assert(near(q, 0, 0));
+	}
+
+	// Runs along an edge, and parallel to it just outside
+	p = clip({0, 0}, {-5, 15});
+	assert(p.size() == 1);
+	check_piece(p[0], {{0, 0}, {0, 10}});
+	assert(clip({-1, -1}, {-5, 15}).empty());
+
+	// Ends exactly on the boundary
+	p = clip({5, 10}, {5, 5});
+	assert(p.size() == 1);
+	check_piece(p[0], {{5, 5}, {10, 5}});
+}
+
+TEST_CASE(test_non_finite_vertex_splits) {
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	Pieces p = clip({1, 2, 3, 4, 5}, {1, 2, nan, 4, 5});
+	assert(p.size() == 2);
+	check_piece(p[0], {{1, 1}, {2, 2}});
+	check_piece(p[1], {{4, 4}, {5, 5}});
+}
+
+int main() {
+	std::cout << "Running line clipping tests...\n";
+
+	RUN_TEST(test_inside_and_outside);
+	RUN_TEST(test_crossing_edges);
+	RUN_TEST(test_corners_and_edges);
+	RUN_TEST(test_non_finite_vertex_splits);
+
+	std::cout << "All line clipping tests passed!\n";
+	return 0;
+}
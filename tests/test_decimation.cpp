@@ -0,0 +1,174 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+#include "display_list.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+struct Point {
+	double x, y;
+};
+
+// Keeps the vertices of every polyline, the only primitive series lines use
+struct PolylineRecorder {
+	std::vector<std::vector<Point>> polylines;
+
+	void line(double, double, double, double, const std::string&, double, const std::string&) {}
+	void begin_polyline(const std::string&, double) { polylines.emplace_back(); }
+	void polyline_point(double x, double y) { polylines.back().push_back({x, y}); }
+	void end_polyline() {}
+	void circle(double, double, double, const std::string&) {}
+	void begin_markers(const std::string&, double) {}
+	void marker(double, double) {}
+	void end_markers() {}
+	void text(double, double, const std::string&, const std::string&, int, const std::string&, double) {}
+	void rect(double, double, double, double, const std::string&, double, const std::string&) {}
+	void begin_group_translate(double, double) {}
+	void end_group() {}
+};
+
+std::vector<Point> render_line(const std::vector<double>& x, const std::vector<double>& y, const LineDecimation& decimation) {
+	Axes ax(800, 600);
+	ax.plot(x, y, Rgba::Blue(), 1.0, "", decimation);
+	DisplayListCanvas list(800, 600);
+	ax.render_to(list, 0, 0, 800, 600);
+	PolylineRecorder rec;
+	list.replay(rec);
+	assert(rec.polylines.size() == 1);
+	return rec.polylines[0];
+}
+
+bool same_point(const Point& a, const Point& b) {
+	if (std::isnan(a.x) || std::isnan(b.x)) return std::isnan(a.x) && std::isnan(b.x) && a.y == b.y;
+	return a.x == b.x && a.y == b.y;
+}
+
+// First, min-Y, max-Y and last vertex of every run of vertices in one pixel column
+std::vector<Point> m4_reference(const std::vector<Point>& full) {
+	std::vector<Point> out;
+	size_t i = 0;
+	while (i < full.size()) {
+		if (!std::isfinite(full[i].x)) {
+			out.push_back(full[i++]);
+			continue;
+		}
+		const double column = std::floor(full[i].x);
+		size_t end = i, lo = i, hi = i;
+		while (end < full.size() && std::isfinite(full[end].x) && std::floor(full[end].x) == column) {
+			if (full[end].y < full[lo].y) lo = end;
+			if (full[end].y > full[hi].y) hi = end;
+			++end;
+		}
+		size_t keep[4] = {i, std::min(lo, hi), std::max(lo, hi), end - 1};
+		size_t emitted = keep[0];
+		out.push_back(full[keep[0]]);
+		for (size_t k = 1; k < 4; ++k) {
+			if (keep[k] != emitted) out.push_back(full[keep[k]]);
+			emitted = keep[k];
+		}
+		i = end;
+	}
+	return out;
+}
+
+TEST_CASE(test_m4_keeps_column_extremes) {
+	std::vector<double> x(20000), y(x.size());
+	for (size_t i = 0; i < x.size(); ++i) {
+		x[i] = static_cast<double>(i);
+		y[i] = std::sin(i * 0.05) + 0.3 * std::sin(i * 1.7);
+	}
+	const std::vector<Point> full = render_line(x, y, LineDecimation::none());
+	const std::vector<Point> m4 = render_line(x, y, LineDecimation::min_max());
+	assert(full.size() == x.size());
+	assert(m4.size() < full.size() / 4);
+
+	const std::vector<Point> expected = m4_reference(full);
+	assert(m4.size() == expected.size());
+	for (size_t i = 0; i < m4.size(); ++i) assert(same_point(m4[i], expected[i]));
+}
+
+TEST_CASE(test_m4_passes_non_finite_samples) {
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	std::vector<double> x(3000), y(x.size());
+	for (size_t i = 0; i < x.size(); ++i) {
+		x[i] = static_cast<double>(i);
+		y[i] = std::cos(i * 0.01);
+	}
+	x[1500] = nan;
+	std::vector<Point> m4 = render_line(x, y, LineDecimation::min_max());
+	std::vector<Point> expected = m4_reference(render_line(x, y, LineDecimation::none()));
+	assert(m4.size() == expected.size());
+	size_t nonFinite = 0;
+	for (size_t i = 0; i < m4.size(); ++i) {
+		assert(same_point(m4[i], expected[i]));
+		if (!std::isfinite(m4[i].x)) ++nonFinite;
+	}
+	assert(nonFinite == 1);
+
+	// An infinite sample makes the x-range infinite, so no vertex has a column
+	x[1500] = std::numeric_limits<double>::infinity();
+	m4 = render_line(x, y, LineDecimation::min_max());
+	assert(m4.size() == x.size());
+
+	// All x equal: a degenerate range still renders
+	std::vector<double> flat(100, 5.0);
+	assert(!render_line(flat, std::vector<double>(y.begin(), y.begin() + 100), LineDecimation::min_max()).empty());
+}
+
+TEST_CASE(test_parallel_lttb_matches_sequential) {
+	std::mt19937 rng(11);
+	std::normal_distribution<double> step(0.0, 1.0);
+	const size_t sizes[] = {3, 10, 1000, 4097, 250000};
+	const size_t thresholds[] = {3, 4, 100, 999, 5000};
+	for (size_t n : sizes) {
+		std::vector<double> x(n), y(n);
+		double walk = 0.0;
+		for (size_t i = 0; i < n; ++i) {
+			x[i] = static_cast<double>(i);
+			walk += step(rng);
+			// Quantized values give equal triangle areas, so tie-breaking is checked too
+			y[i] = std::round(walk);
+		}
+		for (size_t threshold : thresholds) {
+			const std::vector<size_t> seq = lttb_indices(x.data(), y.data(), n, threshold, false);
+			const std::vector<size_t> par = lttb_indices(x.data(), y.data(), n, threshold, true);
+			assert(seq == par);
+			assert(seq.size() == std::min(n, threshold));
+			assert(seq.front() == 0 && seq.back() == n - 1);
+			for (size_t i = 1; i < seq.size(); ++i) assert(seq[i] > seq[i - 1]);
+		}
+	}
+
+	// Same polyline through the render path
+	std::vector<double> x(100000), y(x.size());
+	for (size_t i = 0; i < x.size(); ++i) {
+		x[i] = static_cast<double>(i);
+		y[i] = std::sin(i * 0.001) + 0.1 * std::sin(i * 0.37);
+	}
+	const std::vector<Point> seq = render_line(x, y, LineDecimation::lttb(800, false));
+	const std::vector<Point> par = render_line(x, y, LineDecimation::lttb(800, true));
+	assert(seq.size() == 800 && par.size() == seq.size());
+	for (size_t i = 0; i < seq.size(); ++i) assert(same_point(seq[i], par[i]));
+}
+
+int main() {
+	std::cout << "Running line decimation tests...\n";
+
+	RUN_TEST(test_m4_keeps_column_extremes);
+	RUN_TEST(test_m4_passes_non_finite_samples);
+	RUN_TEST(test_parallel_lttb_matches_sequential);
+
+	std::cout << "All line decimation tests passed!\n";
+	return 0;
+}
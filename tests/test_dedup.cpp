@@ -0,0 +1,158 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+#include "number_format.hpp"
+#include "scatter_dedup.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+std::string text_of(double v, int precision) {
+	char out[NumberFormatter::kMaxChars];
+	return std::string(out, NumberFormatter(precision).format(v, out));
+}
+
+std::vector<size_t> dedup(const std::vector<double>& x, const std::vector<double>& y, int precision, const DataBounds* view = nullptr) {
+	// Identity mapping, so data values are the pixel coordinates
+	const AxisAffine identity{0.0, 1.0, 0.0};
+	auto keep = dedup_points(SampleColumn::of(x.data()), SampleColumn::of(y.data()), x.size(),
+		identity, identity, precision, view, std::pmr::new_delete_resource());
+	return std::vector<size_t>(keep.begin(), keep.end());
+}
+
+// The <circle> elements of the (single) scatter series of an SVG
+std::vector<std::string> markers_of(const std::string& svg) {
+	std::vector<std::string> circles;
+	const size_t begin = svg.find("<g fill=\"");
+	const size_t end = svg.find("</g>", begin);
+	for (size_t pos = svg.find("<circle", begin); pos < end; pos = svg.find("<circle", pos)) {
+		const size_t close = svg.find("/>", pos) + 2;
+		circles.push_back(svg.substr(pos, close - pos));
+		pos = close;
+	}
+	return circles;
+}
+
+std::string svg_of(const std::vector<double>& x, const std::vector<double>& y, bool dedupOverdraw, int precision) {
+	Figure fig(400, 300);
+	fig.set_svg_precision(precision);
+	fig.subplot(1, 1, 1).scatter(x, y, 2.0, Rgba::Blue(), "", ScatterMode::markers(dedupOverdraw));
+	std::ostringstream out;
+	fig.save(out);
+	return out.str();
+}
+
+TEST_CASE(test_keys_follow_formatted_text) {
+	std::mt19937_64 rng(7);
+	std::uniform_real_distribution<double> pixel(-50.0, 1000.0);
+	std::uniform_int_distribution<int> ulps(0, 4);
+	for (int precision = 1; precision <= NumberFormatter::kMaxPrecision; ++precision) {
+		const CoordinateKey key(precision);
+		for (int i = 0; i < 20000; ++i) {
+			// Neighbouring values, with and without a shared rounding
+			const double a = i % 2 ? pixel(rng) : std::round(pixel(rng) * 8) / 8;
+			double b = a;
+			for (int u = ulps(rng); u > 0; --u) b = std::nextafter(b, 2000.0);
+			if (i % 3 == 0) b = a + 1e-7 * ulps(rng);
+			if (precision <= CoordinateKey::kMaxDecimalDigits) {
+				assert((key(a) == key(b)) == (text_of(a, precision) == text_of(b, precision)));
+			} else {
+				assert((key(a) == key(b)) == (a == b));
+			}
+		}
+		assert(key(0.0) != key(-0.0));
+		assert(key(1e-300) != key(1e300));
+		assert(key(123456.0) != key(-123456.0));
+	}
+}
+
+TEST_CASE(test_close_points_that_print_apart_are_kept) {
+	// A hundredth of a pixel apart: well inside one 1/16 pixel cell
+	const std::vector<double> x = {10.0, 10.01, 10.02, 10.0};
+	const std::vector<double> y = {5.0, 5.0, 5.0, 5.0};
+	assert((dedup(x, y, 6) == std::vector<size_t>{0, 1, 2}));
+	// At three digits they all print as 10
+	assert((dedup(x, y, 3) == std::vector<size_t>{0}));
+	// Full precision only merges identical doubles
+	assert((dedup(x, y, NumberFormatter::kMaxPrecision) == std::vector<size_t>{0, 1, 2}));
+}
+
+TEST_CASE(test_non_finite_points_pass_through) {
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	const double inf = std::numeric_limits<double>::infinity();
+	const std::vector<double> x = {1.0, nan, nan, inf, 1.0};
+	const std::vector<double> y = {1.0, 2.0, 2.0, 3.0, 1.0};
+	assert((dedup(x, y, 6) == std::vector<size_t>{0, 1, 2, 3}));
+}
+
+TEST_CASE(test_output_is_undeduped_output_without_repeats) {
+	std::mt19937_64 rng(11);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	std::vector<double> x, y;
+	for (int i = 0; i < 20000; ++i) {
+		// Clustered points, half of them on a coarse lattice so exact repeats occur
+		double px = dist(rng), py = dist(rng);
+		if (i % 2) {
+			px = std::round(px * 50) / 50;
+			py = std::round(py * 50) / 50;
+		}
+		x.push_back(px);
+		y.push_back(py);
+	}
+	for (int precision : {3, 4, 6, 9, 17}) {
+		const std::vector<std::string> full = markers_of(svg_of(x, y, false, precision));
+		const std::vector<std::string> deduped = markers_of(svg_of(x, y, true, precision));
+		assert(full.size() == x.size());
+		std::vector<std::string> expected;
+		std::set<std::string> seen;
+		for (const std::string& c : full) {
+			if (seen.insert(c).second) expected.push_back(c);
+		}
+		assert(deduped == expected);
+		assert(deduped.size() < full.size());
+	}
+}
+
+TEST_CASE(test_clipped_points_do_not_hide_visible_ones) {
+	// The first point lies just outside the x limits but prints at the same
+	// pixel as the in-view point after it
+	const std::vector<double> x = {10.0000001, 10.0, 5.0};
+	const std::vector<double> y = {1.0, 1.0, 1.0};
+	const DataBounds view{0.0, 10.0, 0.0, 2.0, false};
+	assert((dedup(x, y, 3) == std::vector<size_t>{0, 2}));
+	assert((dedup(x, y, 3, &view) == std::vector<size_t>{1, 2}));
+
+	Figure fig(400, 300);
+	Axes& ax = fig.subplot(1, 1, 1);
+	ax.scatter(x, y, 2.0, Rgba::Blue(), "", ScatterMode::markers(true));
+	ax.set_xlim(0.0, 10.0);
+	ax.set_ylim(0.0, 2.0);
+	std::ostringstream out;
+	fig.save(out);
+	assert(markers_of(out.str()).size() == 2);
+}
+
+int main() {
+	std::cout << "Running dedup tests...\n";
+	RUN_TEST(test_keys_follow_formatted_text);
+	RUN_TEST(test_close_points_that_print_apart_are_kept);
+	RUN_TEST(test_non_finite_points_pass_through);
+	RUN_TEST(test_output_is_undeduped_output_without_repeats);
+	RUN_TEST(test_clipped_points_do_not_hide_visible_ones);
+	std::cout << "All dedup tests passed!\n";
+	return 0;
+}
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+#include "counting_canvas.hpp"
+#include "density.hpp"
+#include "display_list.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+DensityGrid bin(const std::vector<double>& x, const std::vector<double>& y, double width, double height, int binPx) {
+	return bin_density(SampleColumn::of(x.data()), SampleColumn::of(y.data()), x.size(),
+		0.0, 10.0, -5.0, 5.0, width, height, binPx, false, std::pmr::new_delete_resource());
+}
+
+uint32_t total(const DensityGrid& g) { return std::accumulate(g.counts.begin(), g.counts.end(), 0u); }
+
+uint32_t at(const DensityGrid& g, int col, int row) { return g.counts[static_cast<size_t>(row) * g.cols + col]; }
+
+TEST_CASE(test_edges_are_binned) {
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	// The four corners, a point on each edge, one inside, and points just outside
+	std::vector<double> x = {0, 10, 0, 10, 5, 5, 0, 10, 5, -1e-9, 10.000001, 5, nan};
+	std::vector<double> y = {-5, -5, 5, 5, -5, 5, 0, 0, 0, 0, 0, 5.5, 0};
+	// Plot sizes that are and are not a multiple of the bin size
+	for (int binPx : {1, 4, 3}) {
+		DensityGrid g = bin(x, y, 120, 60, binPx);
+		assert(total(g) == 9);
+		assert(at(g, 0, 0) == 1);                  // (xmin, ymax)
+		assert(at(g, g.cols - 1, 0) == 1);         // (xmax, ymax)
+		assert(at(g, 0, g.rows - 1) == 1);         // (xmin, ymin)
+		assert(at(g, g.cols - 1, g.rows - 1) == 1); // (xmax, ymin)
+	}
+}
+
+// Total area of the filled rects; density cells are the only filled ones
+struct FilledArea {
+	double area{0};
+
+	void line(double, double, double, double, const std::string&, double, const std::string&) {}
+	void begin_polyline(const std::string&, double) {}
+	void polyline_point(double, double) {}
+	void end_polyline() {}
+	void circle(double, double, double, const std::string&) {}
+	void begin_markers(const std::string&, double) {}
+	void marker(double, double) {}
+	void end_markers() {}
+	void text(double, double, const std::string&, const std::string&, int, const std::string&, double) {}
+	void rect(double, double, double w, double h, const std::string&, double, const std::string& fill) {
+		if (fill != "none") area += w * h;
+	}
+	void begin_group_translate(double, double) {}
+	void end_group() {}
+};
+
+TEST_CASE(test_density_matches_markers) {
+	// Limits at the data extent put the extreme points exactly on the edges;
+	// every point gets its own pixel
+	std::vector<double> x, y;
+	for (int i = 0; i <= 40; ++i) {
+		for (int j = 0; j <= 20; ++j) {
+			x.push_back(i * 0.25);
+			y.push_back(j * 0.5 - 5.0);
+		}
+	}
+	auto axes = [&](const ScatterMode& mode) {
+		Axes ax(800, 600);
+		ax.scatter(x, y, 3.0, Rgba::Red(), "", mode);
+		ax.set_xlim(0, 10);
+		ax.set_ylim(-5, 5);
+		return ax;
+	};
+	CountingCanvas markers;
+	axes(ScatterMode::markers()).render_to(markers, 0, 0, 800, 600);
+	assert(markers.stats().circles == x.size());
+
+	DisplayListCanvas list(800, 600);
+	axes(ScatterMode::density()).render_to(list, 0, 0, 800, 600);
+	FilledArea density;
+	list.replay(density);
+	assert(density.area == static_cast<double>(x.size()));
+}
+
+int main() {
+	std::cout << "Running density tests...\n";
+
+	RUN_TEST(test_edges_are_binned);
+	RUN_TEST(test_density_matches_markers);
+
+	std::cout << "All density tests passed!\n";
+	return 0;
+}
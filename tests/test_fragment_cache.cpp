@@ -0,0 +1,117 @@
+#include <iostream>
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+std::string svg_of(const Figure& fig) {
+	std::ostringstream out;
+	fig.save(out);
+	return out.str();
+}
+
+// A figure drawn from scratch, to compare against one updated in place
+std::string fresh_svg(const std::vector<double>& lx, const std::vector<double>& ly,
+	const std::vector<double>& sx, const std::vector<double>& sy, int precision = 6) {
+	Figure fig(640, 480);
+	fig.set_svg_precision(precision);
+	fig.axes().plot(lx, ly, Rgba::Blue(), 2.0, "line");
+	fig.axes().scatter(sx, sy, 3.0, Rgba::Red(), "points");
+	return svg_of(fig);
+}
+
+TEST_CASE(test_append_within_bounds) {
+	std::vector<double> lx = {0, 4, 10}, ly = {0, 7, 10};
+	std::vector<double> sx = {1, 9}, sy = {2, 8};
+	Figure fig(640, 480);
+	SeriesHandle line = fig.axes().plot(lx, ly, Rgba::Blue(), 2.0, "line");
+	SeriesHandle points = fig.axes().scatter(sx, sy, 3.0, Rgba::Red(), "points");
+	assert(svg_of(fig) == fresh_svg(lx, ly, sx, sy));
+
+	// Bounds and mapping are unchanged, so only the new samples are formatted
+	line.append(5.5, 2.25);
+	points.append({3, 4}, {5, 6});
+	lx.push_back(5.5);
+	ly.push_back(2.25);
+	sx.insert(sx.end(), {3, 4});
+	sy.insert(sy.end(), {5, 6});
+	assert(svg_of(fig) == fresh_svg(lx, ly, sx, sy));
+	assert(svg_of(fig) == fresh_svg(lx, ly, sx, sy));
+}
+
+TEST_CASE(test_append_growing_bounds) {
+	std::vector<double> lx = {0, 1, 2}, ly = {0, 1, 0};
+	std::vector<double> sx = {0.5}, sy = {0.5};
+	Figure fig(640, 480);
+	SeriesHandle line = fig.axes().plot(lx, ly, Rgba::Blue(), 2.0, "line");
+	SeriesHandle points = fig.axes().scatter(sx, sy, 3.0, Rgba::Red(), "points");
+	svg_of(fig);
+
+	// New extremes change every mapped coordinate
+	line.append(40.0, -3.0);
+	points.append(-7.0, 12.0);
+	lx.push_back(40.0);
+	ly.push_back(-3.0);
+	sx.push_back(-7.0);
+	sy.push_back(12.0);
+	assert(svg_of(fig) == fresh_svg(lx, ly, sx, sy));
+}
+
+TEST_CASE(test_style_changes_invalidate) {
+	std::vector<double> lx = {0, 1, 2, 3}, ly = {0.123456789, 1.5, 0.25, 2.0};
+	std::vector<double> sx = {0.333333333, 2.5}, sy = {1.0, 0.666666667};
+	Figure fig(640, 480);
+	fig.axes().plot(lx, ly, Rgba::Blue(), 2.0, "line");
+	fig.axes().scatter(sx, sy, 3.0, Rgba::Red(), "points");
+	svg_of(fig);
+
+	fig.set_svg_precision(3);
+	assert(svg_of(fig) == fresh_svg(lx, ly, sx, sy, 3));
+	fig.set_svg_precision(6);
+	assert(svg_of(fig) == fresh_svg(lx, ly, sx, sy, 6));
+
+	// Limits change the mapping; clearing them goes back to the data extent
+	Figure limited(640, 480);
+	limited.axes().plot(lx, ly, Rgba::Blue(), 2.0, "line");
+	limited.axes().scatter(sx, sy, 3.0, Rgba::Red(), "points");
+	limited.axes().set_ylim(-1, 5);
+	fig.axes().set_ylim(-1, 5);
+	assert(svg_of(fig) == svg_of(limited));
+}
+
+TEST_CASE(test_ring_append) {
+	Figure fig(640, 480);
+	SeriesHandle ring = fig.axes().plot_ring(4, Rgba::Blue(), 2.0, "line");
+	fig.axes().scatter(std::vector<double>{0, 10}, std::vector<double>{0, 10}, 3.0, Rgba::Red(), "points");
+	for (int i = 0; i < 3; ++i) ring.append(i, i % 2);
+	const std::string before = svg_of(fig);
+	for (int i = 3; i < 7; ++i) ring.append(i, i % 2);
+	const std::string after = svg_of(fig);
+	assert(after != before);
+	assert(ring.size() == 4);
+
+	// The newest four samples, drawn as an ordinary series
+	std::vector<double> lx = {3, 4, 5, 6}, ly = {1, 0, 1, 0};
+	assert(after == fresh_svg(lx, ly, {0, 10}, {0, 10}));
+}
+
+int main() {
+	std::cout << "Running series fragment cache tests...\n";
+
+	RUN_TEST(test_append_within_bounds);
+	RUN_TEST(test_append_growing_bounds);
+	RUN_TEST(test_style_changes_invalidate);
+	RUN_TEST(test_ring_append);
+
+	std::cout << "All series fragment cache tests passed!\n";
+	return 0;
+}
@@ -0,0 +1,268 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+#include "png_writer.hpp"
+#include "raster_canvas.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+// Independent decoder for what the writer produces: zlib streams with stored
+// or fixed-Huffman deflate blocks, and 8-bit RGBA PNGs with filters 0-4
+
+class BitReader {
+public:
+	BitReader(const uint8_t* data, size_t size) : p(data), end(data + size) {}
+
+	uint32_t bits(int count) {
+		uint32_t v = 0;
+		for (int k = 0; k < count; ++k) v |= static_cast<uint32_t>(bit()) << k;
+		return v;
+	}
+	// Huffman codes are packed most significant bit first
+	uint32_t code(int count) {
+		uint32_t v = 0;
+		for (int k = 0; k < count; ++k) v = (v << 1) | bit();
+		return v;
+	}
+	void align() { used = 0; ++p; }
+	const uint8_t* pos() const { return used == 0 ? p : p + 1; }
+	void skip_to(const uint8_t* q) { p = q; used = 0; }
+
+private:
+	uint32_t bit() {
+		if (p >= end) throw std::runtime_error("deflate stream is truncated");
+		uint32_t b = (*p >> used) & 1u;
+		if (++used == 8) { used = 0; ++p; }
+		return b;
+	}
+
+	const uint8_t* p;
+	const uint8_t* end;
+	int used{0};
+};
+
+int fixed_litlen(BitReader& in) {
+	uint32_t c = in.code(7);
+	if (c <= 23) return 256 + static_cast<int>(c);
+	c = (c << 1) | in.code(1);
+	if (c >= 48 && c <= 191) return static_cast<int>(c - 48);
+	if (c >= 192 && c <= 199) return 280 + static_cast<int>(c - 192);
+	c = (c << 1) | in.code(1);
+	return 144 + static_cast<int>(c - 400);
+}
+
+uint32_t adler32(const std::vector<uint8_t>& v) {
+	uint32_t a = 1, b = 0;
+	for (uint8_t x : v) {
+		a = (a + x) % 65521;
+		b = (b + a) % 65521;
+	}
+	return (b << 16) | a;
+}
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+	uint32_t c = 0xFFFFFFFFu;
+	for (size_t i = 0; i < size; ++i) {
+		c ^= data[i];
+		for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+	}
+	return c ^ 0xFFFFFFFFu;
+}
+
+uint32_t be32(const uint8_t* p) {
+	return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+std::vector<uint8_t> zlib_decompress(const std::vector<uint8_t>& z) {
+	static const int lenBase[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+	static const int lenExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+	static const int distBase[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+	static const int distExtra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+	assert(z.size() >= 6);
+	assert((z[0] & 0x0F) == 8);                    // deflate
+	assert(((z[0] << 8) | z[1]) % 31 == 0);        // header check bits
+	assert((z[1] & 0x20) == 0);                    // no preset dictionary
+	std::vector<uint8_t> out;
+	BitReader in(z.data() + 2, z.size() - 2);
+	bool last = false;
+	while (!last) {
+		last = in.bits(1) == 1;
+		uint32_t type = in.bits(2);
+		if (type == 0) {
+			const uint8_t* p = in.pos();
+			uint32_t len = p[0] | (p[1] << 8), nlen = p[2] | (p[3] << 8);
+			assert((len ^ 0xFFFFu) == nlen);
+			out.insert(out.end(), p + 4, p + 4 + len);
+			in.skip_to(p + 4 + len);
+			continue;
+		}
+		assert(type == 1);
+		for (;;) {
+			int sym = fixed_litlen(in);
+			if (sym < 256) { out.push_back(static_cast<uint8_t>(sym)); continue; }
+			if (sym == 256) break;
+			assert(sym <= 285);
+			int len = lenBase[sym - 257] + static_cast<int>(in.bits(lenExtra[sym - 257]));
+			int dsym = static_cast<int>(in.code(5));
+			assert(dsym < 30);
+			size_t dist = static_cast<size_t>(distBase[dsym]) + in.bits(distExtra[dsym]);
+			assert(dist <= out.size() && dist <= 32768);
+			for (int k = 0; k < len; ++k) out.push_back(out[out.size() - dist]);
+		}
+	}
+	const uint8_t* tail = in.pos();
+	assert(tail + 4 == z.data() + z.size());
+	assert(be32(tail) == adler32(out));
+	return out;
+}
+
+struct DecodedPng {
+	int width{0}, height{0};
+	std::vector<uint8_t> rgba;
+};
+
+DecodedPng decode_png(const std::string& file) {
+	const uint8_t* p = reinterpret_cast<const uint8_t*>(file.data());
+	const uint8_t* end = p + file.size();
+	static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	assert(file.size() >= 8 && std::equal(signature, signature + 8, p));
+	p += 8;
+	DecodedPng png;
+	std::vector<uint8_t> idat;
+	bool sawEnd = false;
+	bool first = true;
+	while (p < end) {
+		assert(end - p >= 12);
+		uint32_t len = be32(p);
+		std::string type(reinterpret_cast<const char*>(p + 4), 4);
+		assert(static_cast<size_t>(end - p) >= 12 + len);
+		assert(be32(p + 8 + len) == crc32(p + 4, 4 + len));
+		const uint8_t* data = p + 8;
+		assert(!first || type == "IHDR");
+		first = false;
+		if (type == "IHDR") {
+			assert(len == 13);
+			png.width = static_cast<int>(be32(data));
+			png.height = static_cast<int>(be32(data + 4));
+			assert(data[8] == 8 && data[9] == 6 && data[10] == 0 && data[11] == 0 && data[12] == 0);
+		} else if (type == "IDAT") {
+			idat.insert(idat.end(), data, data + len);
+		} else if (type == "IEND") {
+			assert(len == 0);
+			sawEnd = true;
+		}
+		p += 12 + len;
+	}
+	assert(sawEnd);
+
+	const std::vector<uint8_t> raw = zlib_decompress(idat);
+	const size_t stride = static_cast<size_t>(png.width) * 4;
+	assert(raw.size() == (stride + 1) * static_cast<size_t>(png.height));
+	png.rgba.resize(stride * static_cast<size_t>(png.height));
+	for (int y = 0; y < png.height; ++y) {
+		const uint8_t* src = raw.data() + static_cast<size_t>(y) * (stride + 1);
+		uint8_t* row = png.rgba.data() + static_cast<size_t>(y) * stride;
+		const uint8_t* above = y > 0 ? row - stride : nullptr;
+		const uint8_t filter = src[0];
+		assert(filter <= 4);
+		for (size_t i = 0; i < stride; ++i) {
+			int a = i >= 4 ? row[i - 4] : 0;
+			int b = above ? above[i] : 0;
+			int c = i >= 4 && above ? above[i - 4] : 0;
+			int pred = 0;
+			if (filter == 1) pred = a;
+			else if (filter == 2) pred = b;
+			else if (filter == 3) pred = (a + b) / 2;
+			else if (filter == 4) {
+				int pa = std::abs(b - c), pb = std::abs(a - c), pc = std::abs(a + b - 2 * c);
+				pred = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+			}
+			row[i] = static_cast<uint8_t>(src[1 + i] + pred);
+		}
+	}
+	return png;
+}
+
+void check_zlib_round_trip(const std::vector<uint8_t>& data) {
+	assert(zlib_decompress(zlib_compress(data.data(), data.size())) == data);
+}
+
+TEST_CASE(test_zlib_round_trip) {
+	check_zlib_round_trip({});
+	check_zlib_round_trip({42});
+	check_zlib_round_trip({1, 2});
+
+	std::mt19937 rng(3);
+	std::vector<uint8_t> noise(100000);
+	for (auto& b : noise) b = static_cast<uint8_t>(rng());
+	check_zlib_round_trip(noise);
+
+	// Long runs (matches capped at 258), short repeats and far matches across the 32K window
+	std::vector<uint8_t> mixed(200000, 7);
+	for (size_t i = 50000; i < 120000; ++i) mixed[i] = static_cast<uint8_t>(i % 5);
+	for (size_t i = 120000; i < 200000; ++i) mixed[i] = noise[i % 40000];
+	check_zlib_round_trip(mixed);
+}
+
+TEST_CASE(test_png_round_trip) {
+	RasterCanvas canvas(123, 77);
+	canvas.rect(10, 10, 60, 40, "black", 2.0, "rgba(0,128,255,0.5)");
+	canvas.line(0, 0, 122, 76, "red", 3.0);
+	canvas.circle(90, 30, 12, "#33aa55");
+	canvas.text(5, 70, "catplot 0.1", "black", 12);
+	std::ostringstream out;
+	write_png(out, canvas.pixels(), canvas.width(), canvas.height());
+
+	const DecodedPng png = decode_png(out.str());
+	assert(png.width == 123 && png.height == 77);
+	assert(std::equal(png.rgba.begin(), png.rgba.end(), canvas.pixels()));
+
+	bool threw = false;
+	try { write_png(out, canvas.pixels(), 0, 10); } catch (const std::invalid_argument&) { threw = true; }
+	assert(threw);
+}
+
+TEST_CASE(test_figure_png_decodes) {
+	Figure fig(320, 240);
+	std::vector<double> x = {0, 1, 2, 3}, y = {1, 3, 2, 4};
+	fig.axes().plot(x, y, Rgba::Blue(), 2.0, "line");
+	fig.axes().scatter(x, y, 3.0, Rgba::Red());
+	fig.axes().set_title("png");
+	std::ostringstream out;
+	fig.save_png(out);
+
+	const DecodedPng png = decode_png(out.str());
+	assert(png.width == 320 && png.height == 240);
+	// Opaque white background with some drawing on it
+	size_t white = 0;
+	for (size_t i = 0; i < png.rgba.size(); i += 4) {
+		assert(png.rgba[i + 3] == 255);
+		if (png.rgba[i] == 255 && png.rgba[i + 1] == 255 && png.rgba[i + 2] == 255) ++white;
+	}
+	assert(white > 0 && white < png.rgba.size() / 4);
+}
+
+int main() {
+	std::cout << "Running PNG writer tests...\n";
+
+	RUN_TEST(test_zlib_round_trip);
+	RUN_TEST(test_png_round_trip);
+	RUN_TEST(test_figure_png_decodes);
+
+	std::cout << "All PNG writer tests passed!\n";
+	return 0;
+}
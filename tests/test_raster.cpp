@@ -0,0 +1,59 @@
+#include <iostream>
+#include <cassert>
+#include "raster_canvas.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+int count_dark(const RasterCanvas& canvas) {
+	int n = 0;
+	const uint8_t* p = canvas.pixels();
+	for (int i = 0; i < canvas.width() * canvas.height(); ++i) if (p[i * 4] < 128) ++n;
+	return n;
+}
+
+int stroke_dark(double x1, double y1, double x2, double y2) {
+	RasterCanvas canvas(800, 200);
+	canvas.begin_polyline("black", 2.0);
+	canvas.polyline_point(x1, y1);
+	canvas.polyline_point(x2, y2);
+	canvas.end_polyline();
+	return count_dark(canvas);
+}
+
+TEST_CASE(test_nearly_horizontal_segment) {
+	// A tiny dy used to overflow the scanline span and drop the whole segment
+	const int flat = stroke_dark(10, 100, 700, 100);
+	assert(flat > 0);
+	assert(stroke_dark(10, 100, 700, 100 + 1e-12) == flat);
+	assert(stroke_dark(10, 100, 700, 100 + 1e-8) == flat);
+	assert(stroke_dark(10, 100, 700, 100 + 1e-6) == flat);
+	assert(stroke_dark(700, 100 - 1e-8, 10, 100) == flat);
+}
+
+TEST_CASE(test_far_off_canvas_coordinates) {
+	// Coordinates far outside int range are clipped, not cast
+	assert(stroke_dark(-1e12, 100, 1e12, 100) == 800 * 2);
+	assert(stroke_dark(-1e12, -1e12, -1e12 + 1, -1e12) == 0);
+
+	RasterCanvas canvas(100, 100);
+	canvas.circle(1e15, 50, 5, "black");
+	canvas.rect(-1e15, 40, 2e15, 20, "none", 0.0, "black");
+	canvas.text(1e15, 50, "x");
+	assert(count_dark(canvas) == 100 * 20);
+}
+
+int main() {
+	std::cout << "Running raster canvas tests...\n";
+
+	RUN_TEST(test_nearly_horizontal_segment);
+	RUN_TEST(test_far_off_canvas_coordinates);
+
+	std::cout << "All raster canvas tests passed!\n";
+	return 0;
+}
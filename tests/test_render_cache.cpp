@@ -0,0 +1,173 @@
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "catplot/catplot.hpp"
+
+using namespace catplot;
+
+#define TEST_CASE(name) void name()
+#define RUN_TEST(name)  \
+	std::cout << "Running " #name "... "; \
+	name(); \
+	std::cout << "OK\n";
+
+std::string svg_of(const Figure& fig) {
+	std::ostringstream out;
+	fig.save(out);
+	return out.str();
+}
+
+// 2x2 grid with one series and a title per subplot
+std::vector<SeriesHandle> fill(Figure& fig) {
+	std::vector<SeriesHandle> handles;
+	for (int i = 1; i <= 4; ++i) {
+		Axes& ax = fig.subplot(2, 2, i);
+		handles.push_back(ax.plot(std::vector<double>{0, 1, 2, 3}, std::vector<double>{0, 1.0 * i, 0.5, 2}, Rgba::Blue(), 2.0, "s" + std::to_string(i)));
+		ax.set_title("cell " + std::to_string(i));
+	}
+	return handles;
+}
+
+using Step = std::function<void(Figure&, std::vector<SeriesHandle>&)>;
+
+// Applies the last step to the cached figure and every step to a fresh one;
+// the outputs must match and only the changed subplots may be rendered again
+void check_step(Figure& cached, std::vector<SeriesHandle>& handles, const std::vector<Step>& steps, size_t expectedMisses) {
+	const RenderCacheStats before = cached.render_cache_stats();
+	steps.back()(cached, handles);
+	const std::string svg = svg_of(cached);
+	const RenderCacheStats after = cached.render_cache_stats();
+	assert(after.misses - before.misses == expectedMisses);
+	assert(after.hits - before.hits == 4 - expectedMisses);
+
+	Figure fresh(800, 600);
+	std::vector<SeriesHandle> freshHandles = fill(fresh);
+	for (const Step& step : steps) step(fresh, freshHandles);
+	assert(svg == svg_of(fresh));
+}
+
+TEST_CASE(test_unchanged_figure_hits) {
+	Figure fig(800, 600);
+	fill(fig);
+	fig.set_render_cache(true);
+	const std::string first = svg_of(fig);
+	assert(fig.render_cache_stats().misses == 4);
+	assert(fig.render_cache_stats().hits == 0);
+	assert(svg_of(fig) == first);
+	assert(fig.render_cache_stats().hits == 4);
+
+	Figure plain(800, 600);
+	fill(plain);
+	assert(svg_of(plain) == first);
+}
+
+TEST_CASE(test_changes_invalidate_one_subplot) {
+	Figure fig(800, 600);
+	std::vector<SeriesHandle> handles = fill(fig);
+	fig.set_render_cache(true);
+	svg_of(fig);
+
+	std::vector<Step> steps;
+	steps.push_back([](Figure& f, std::vector<SeriesHandle>&) { f.subplot(2, 2, 2).set_title("renamed"); });
+	check_step(fig, handles, steps, 1);
+	steps.push_back([](Figure& f, std::vector<SeriesHandle>&) { f.subplot(2, 2, 3).grid(true); });
+	check_step(fig, handles, steps, 1);
+	steps.push_back([](Figure& f, std::vector<SeriesHandle>&) { f.subplot(2, 2, 4).legend(true); });
+	check_step(fig, handles, steps, 1);
+	steps.push_back([](Figure& f, std::vector<SeriesHandle>&) { f.subplot(2, 2, 1).set_xlim(0.5, 2.5); });
+	check_step(fig, handles, steps, 1);
+	steps.push_back([](Figure&, std::vector<SeriesHandle>& h) { h[2].append(4.0, 1.0); });
+	check_step(fig, handles, steps, 1);
+	steps.push_back([](Figure& f, std::vector<SeriesHandle>&) {
+		f.subplot(2, 2, 1).set_ylabel("y");
+		f.subplot(2, 2, 4).set_xlabel("x");
+	});
+	check_step(fig, handles, steps, 2);
+}
+
+TEST_CASE(test_precision_and_borrowed_data) {
+	std::vector<double> x = {0, 1, 2}, y = {0.123456789, 1, 2};
+	Figure fig(800, 600);
+	fig.axes().plot(SeriesData::borrow(x), SeriesData::borrow(y));
+	fig.set_render_cache(true);
+	const std::string first = svg_of(fig);
+
+	// Precision is part of the cache key
+	fig.set_svg_precision(3);
+	const std::string rounded = svg_of(fig);
+	assert(rounded != first);
+	fig.set_svg_precision(6);
+	assert(svg_of(fig) == first);
+
+	// Borrowed data changed in place is picked up after mark_changed()
+	y[0] = 0.5;
+	fig.axes().mark_changed();
+	Figure fresh(800, 600);
+	fresh.axes().plot(x, y);
+	assert(svg_of(fig) == svg_of(fresh));
+
+	// Turning the cache off drops it; output is unchanged
+	fig.set_render_cache(false);
+	assert(svg_of(fig) == svg_of(fresh));
+}
+
+TEST_CASE(test_borrowed_x_reordered) {
+	std::vector<double> x(20), y(20);
+	for (size_t i = 0; i < x.size(); ++i) {
+		x[i] = static_cast<double>(i);
+		y[i] = static_cast<double>(i % 5);
+	}
+	Figure fig(800, 600);
+	fig.axes().plot(SeriesData::borrow(x), SeriesData::borrow(y));
+	fig.axes().set_xlim(5.5, 12.5);
+	fig.set_render_cache(true);
+	svg_of(fig);
+
+	// Ascending x lets the renderer visit only the visible range; once x is no
+	// longer sorted every segment has to be considered again
+	std::mt19937 rng(3);
+	for (int trial = 0; trial < 20; ++trial) {
+		std::shuffle(x.begin(), x.end(), rng);
+		fig.axes().mark_changed();
+		Figure fresh(800, 600);
+		fresh.axes().plot(x, y);
+		fresh.axes().set_xlim(5.5, 12.5);
+		assert(svg_of(fig) == svg_of(fresh));
+	}
+}
+
+TEST_CASE(test_parallel_cells_use_cache) {
+	Figure fig(800, 600);
+	fill(fig);
+	fig.set_render_cache(true);
+	fig.set_render_threads(4);
+	const std::string first = svg_of(fig);
+	fig.subplot(2, 2, 3).set_title("changed");
+	const std::string second = svg_of(fig);
+	assert(fig.render_cache_stats().misses == 5);
+	assert(fig.render_cache_stats().hits == 3);
+
+	Figure serial(800, 600);
+	fill(serial);
+	serial.subplot(2, 2, 3).set_title("changed");
+	assert(second == svg_of(serial));
+	assert(first != second);
+}
+
+int main() {
+	std::cout << "Running render cache tests...\n";
+
+	RUN_TEST(test_unchanged_figure_hits);
+	RUN_TEST(test_changes_invalidate_one_subplot);
+	RUN_TEST(test_precision_and_borrowed_data);
+	RUN_TEST(test_borrowed_x_reordered);
+	RUN_TEST(test_parallel_cells_use_cache);
+
+	std::cout << "All render cache tests passed!\n";
+	return 0;
+}